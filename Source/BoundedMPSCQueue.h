@@ -0,0 +1,105 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <atomic>
+#include <memory>
+
+//==============================================================================
+/**
+ * 有界的無鎖佇列（多生產者、單消費者）
+ * Dmitry Vyukov 的 bounded MPMC 演算法：每個槽位有一個序號，生產者以 CAS 取得寫入位置，
+ * 寫完後發布序號；消費者只有一個，所以讀取端不需要 CAS。
+ *
+ * 所有記憶體在建構時配置，push/pop 不配置、不上鎖，可以在音訊線程中使用。
+ * 佇列滿時 tryPush 直接返回 false（由呼叫者決定是否計為丟棄）。
+ */
+template <typename T, size_t Capacity>
+class BoundedMPSCQueue
+{
+public:
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+    BoundedMPSCQueue()
+        : cells(new Cell[Capacity])
+    {
+        for (size_t i = 0; i < Capacity; ++i)
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    // fill(T&) 在取得的槽位上就地寫入資料；返回 false 表示佇列已滿
+    template <typename Fill>
+    bool tryPush(Fill&& fill) noexcept
+    {
+        Cell* cell = nullptr;
+        size_t position = enqueuePosition.load(std::memory_order_relaxed);
+
+        for (;;)
+        {
+            cell = &cells[position & mask];
+            const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            const auto difference = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position);
+
+            if (difference == 0)
+            {
+                if (enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (difference < 0)
+            {
+                return false;  // 滿了
+            }
+            else
+            {
+                position = enqueuePosition.load(std::memory_order_relaxed);
+            }
+        }
+
+        fill(cell->data);
+        cell->sequence.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 只能由單一消費者線程呼叫；consume(const T&) 在槽位上就地讀取
+    template <typename Consume>
+    bool tryPop(Consume&& consume) noexcept
+    {
+        const size_t position = dequeuePosition.load(std::memory_order_relaxed);
+        Cell& cell = cells[position & mask];
+        const size_t sequence = cell.sequence.load(std::memory_order_acquire);
+
+        if (static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position + 1) < 0)
+            return false;  // 空的（或生產者還沒寫完）
+
+        consume(static_cast<const T&>(cell.data));
+        cell.sequence.store(position + Capacity, std::memory_order_release);
+        dequeuePosition.store(position + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // 近似的佇列深度（只用於統計顯示）
+    size_t getApproximateSize() const noexcept
+    {
+        const size_t enqueued = enqueuePosition.load(std::memory_order_relaxed);
+        const size_t dequeued = dequeuePosition.load(std::memory_order_relaxed);
+        return enqueued >= dequeued ? juce::jmin(enqueued - dequeued, Capacity) : 0;
+    }
+
+    static constexpr size_t getCapacity() noexcept { return Capacity; }
+
+private:
+    static constexpr size_t mask = Capacity - 1;
+
+    struct Cell
+    {
+        std::atomic<size_t> sequence { 0 };
+        T data {};
+    };
+
+    std::unique_ptr<Cell[]> cells;
+
+    // 生產者與消費者的位置放在不同的 cache line，避免 false sharing
+    alignas(64) std::atomic<size_t> enqueuePosition { 0 };
+    alignas(64) std::atomic<size_t> dequeuePosition { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE(BoundedMPSCQueue)
+};
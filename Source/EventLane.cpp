@@ -0,0 +1,108 @@
+#include "EventLane.h"
+#include <numeric>
+
+//==============================================================================
+int EventLane::findLastAtOrBefore(double midiTime) const noexcept
+{
+    // upper_bound 返回第一個 > midiTime 的元素，前一個就是 <= midiTime 的最後一個
+    auto upper = std::upper_bound(times.begin(), times.end(), midiTime);
+    return static_cast<int>(upper - times.begin()) - 1;
+}
+
+size_t EventLane::findFirstAfter(double midiTime) const noexcept
+{
+    auto upper = std::upper_bound(times.begin(), times.end(), midiTime);
+    return static_cast<size_t>(upper - times.begin());
+}
+
+//==============================================================================
+void EventLane::append(double midiTime, float x, float y, float z)
+{
+    times.push_back(midiTime);
+    xs.push_back(x);
+    ys.push_back(y);
+    zs.push_back(z);
+}
+
+void EventLane::insert(double midiTime, float x, float y, float z)
+{
+    mergeSortedRun(1, [&](size_t) { return RecordedEvent(midiTime, x, y, z); });
+}
+
+void EventLane::assignColumns(std::vector<double> newTimes, std::vector<float> newXs,
+                              std::vector<float> newYs, std::vector<float> newZs)
+{
+    jassert(newXs.size() == newTimes.size() && newYs.size() == newTimes.size() && newZs.size() == newTimes.size());
+
+    times = std::move(newTimes);
+    xs = std::move(newXs);
+    ys = std::move(newYs);
+    zs = std::move(newZs);
+}
+
+void EventLane::retain(const std::vector<size_t>& sortedIndices)
+{
+    jassert(std::is_sorted(sortedIndices.begin(), sortedIndices.end()));
+
+    // 索引遞增，所以寫入位置永遠不會超過讀取位置
+    size_t w = 0;
+    for (size_t r : sortedIndices)
+    {
+        if (r >= times.size())
+            break;
+
+        times[w] = times[r];
+        xs[w] = xs[r];
+        ys[w] = ys[r];
+        zs[w] = zs[r];
+        ++w;
+    }
+
+    times.resize(w);
+    xs.resize(w);
+    ys.resize(w);
+    zs.resize(w);
+}
+
+void EventLane::reserve(size_t numEvents)
+{
+    times.reserve(numEvents);
+    xs.reserve(numEvents);
+    ys.reserve(numEvents);
+    zs.reserve(numEvents);
+}
+
+void EventLane::clear()
+{
+    times.clear();
+    xs.clear();
+    ys.clear();
+    zs.clear();
+}
+
+//==============================================================================
+void EventLane::sortByTime()
+{
+    if (std::is_sorted(times.begin(), times.end()))
+        return;
+
+    // 先對索引排序，再依排列重新組合每個欄位
+    std::vector<size_t> order(times.size());
+    std::iota(order.begin(), order.end(), static_cast<size_t>(0));
+    std::stable_sort(order.begin(), order.end(),
+        [this](size_t a, size_t b) { return times[a] < times[b]; });
+
+    auto permute = [&order](auto& column)
+    {
+        std::remove_reference_t<decltype(column)> sorted;
+        sorted.reserve(column.size());
+        for (auto i : order)
+            sorted.push_back(column[i]);
+        column.swap(sorted);
+    };
+
+    permute(times);
+    permute(xs);
+    permute(ys);
+    permute(zs);
+}
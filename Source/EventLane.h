@@ -0,0 +1,169 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <vector>
+#include <algorithm>
+
+//==============================================================================
+/**
+ * 錄製的事件（值型別）
+ * 記錄球在某個時間點的位置；球的 ID 由所屬的 EventLane 決定，不再逐事件儲存
+ */
+struct RecordedEvent
+{
+    double midiTime;  // PPQ position (MIDI time)
+    float x;
+    float y;
+    float z;  // 暫時為 0，未來擴展用
+
+    RecordedEvent(double time, float xPos, float yPos, float zPos = 0.0f)
+        : midiTime(time), x(xPos), y(yPos), z(zPos) {}
+};
+
+//==============================================================================
+/**
+ * 唯讀的連續記憶體視圖（C++17 沒有 std::span）
+ */
+template <typename T>
+struct ColumnSpan
+{
+    const T* data = nullptr;
+    size_t size = 0;
+
+    const T* begin() const noexcept { return data; }
+    const T* end() const noexcept { return data + size; }
+    const T& operator[](size_t i) const noexcept { return data[i]; }
+    bool empty() const noexcept { return size == 0; }
+};
+
+//==============================================================================
+/**
+ * 單一球的錄製事件序列（按時間排序）
+ * 以欄位（structure-of-arrays）方式儲存：time / x / y / z 各自是連續的陣列，
+ * 搜尋只需要碰 time 欄位，批次運算也可以直接對整個欄位做向量化處理。
+ *
+ * revision 在每次修改時遞增，讓回放游標知道需要重新定位。
+ */
+class EventLane
+{
+public:
+    EventLane() = default;
+
+    size_t size() const noexcept { return times.size(); }
+    bool empty() const noexcept { return times.empty(); }
+
+    // 欄位視圖
+    ColumnSpan<double> getTimes() const noexcept { return { times.data(), times.size() }; }
+    ColumnSpan<float> getXs() const noexcept { return { xs.data(), xs.size() }; }
+    ColumnSpan<float> getYs() const noexcept { return { ys.data(), ys.size() }; }
+    ColumnSpan<float> getZs() const noexcept { return { zs.data(), zs.size() }; }
+
+    // 取得第 i 個事件（組合成值型別）
+    RecordedEvent getEvent(size_t i) const noexcept { return { times[i], xs[i], ys[i], zs[i] }; }
+    double getTime(size_t i) const noexcept { return times[i]; }
+    double getLastTime() const noexcept { return times.back(); }
+
+    // 返回 <= midiTime 的最後一個事件索引，沒有則返回 -1（只搜尋 time 欄位）
+    int findLastAtOrBefore(double midiTime) const noexcept;
+
+    // 返回第一個 > midiTime 的事件索引，沒有則返回 size()
+    size_t findFirstAfter(double midiTime) const noexcept;
+
+    // 在尾端加入事件（呼叫者負責維持排序，必要時呼叫 sortByTime）
+    void append(double midiTime, float x, float y, float z);
+
+    // 以二分查找定位插入點後就地插入單一事件（相同時間的事件排在既有事件之後）
+    void insert(double midiTime, float x, float y, float z);
+
+    // 合併一段已按時間排序的事件，O(log n + k + 插入點之後的元素數)
+    // getRunEvent(j) 返回第 j 個要合併的 RecordedEvent
+    template <typename EventAccessor>
+    void mergeSortedRun(size_t runLength, EventAccessor&& getRunEvent);
+
+    // 直接以整個欄位取代內容（用於解碼/載入；四個欄位長度必須相同，時間必須已排序）
+    void assignColumns(std::vector<double> newTimes, std::vector<float> newXs,
+                       std::vector<float> newYs, std::vector<float> newZs);
+
+    // 只保留指定索引的事件（索引必須遞增），就地壓縮
+    void retain(const std::vector<size_t>& sortedIndices);
+
+    void reserve(size_t numEvents);
+    void clear();
+
+    // 依時間重新排序（穩定排序，相同時間的事件保持加入順序）
+    void sortByTime();
+
+    juce::uint32 getRevision() const noexcept { return revision; }
+    void markModified() noexcept { ++revision; }
+
+private:
+    std::vector<double> times;
+    std::vector<float> xs;
+    std::vector<float> ys;
+    std::vector<float> zs;
+    juce::uint32 revision = 0;
+
+    JUCE_LEAK_DETECTOR(EventLane)
+};
+
+//==============================================================================
+template <typename EventAccessor>
+void EventLane::mergeSortedRun(size_t runLength, EventAccessor&& getRunEvent)
+{
+    if (runLength == 0)
+        return;
+
+    const size_t oldSize = times.size();
+    const double firstRunTime = getRunEvent(0).midiTime;
+
+    // 快速路徑：整段都在最後一個事件之後（錄製時最常見），直接附加
+    if (oldSize == 0 || firstRunTime >= times.back())
+    {
+        for (size_t j = 0; j < runLength; ++j)
+        {
+            const RecordedEvent e = getRunEvent(j);
+            append(e.midiTime, e.x, e.y, e.z);
+        }
+        return;
+    }
+
+    // 插入點之前的事件都不需要移動
+    const size_t insertionPoint = findFirstAfter(firstRunTime);
+
+    times.resize(oldSize + runLength);
+    xs.resize(oldSize + runLength);
+    ys.resize(oldSize + runLength);
+    zs.resize(oldSize + runLength);
+
+    // 從尾端往前合併，既有事件只搬移一次
+    size_t i = oldSize;          // 尚未處理的既有事件數（含插入點之前）
+    size_t j = runLength;        // 尚未處理的新事件數
+    size_t w = oldSize + runLength;
+
+    RecordedEvent e = getRunEvent(j - 1);
+
+    while (j > 0)
+    {
+        --w;
+
+        if (i > insertionPoint && times[i - 1] > e.midiTime)
+        {
+            --i;
+            times[w] = times[i];
+            xs[w] = xs[i];
+            ys[w] = ys[i];
+            zs[w] = zs[i];
+        }
+        else
+        {
+            --j;
+            times[w] = e.midiTime;
+            xs[w] = e.x;
+            ys[w] = e.y;
+            zs[w] = e.z;
+
+            if (j > 0)
+                e = getRunEvent(j - 1);
+        }
+    }
+}
@@ -1,6 +1,8 @@
 #include "JYPad.h"
 #include "DebugLogger.h"
+#include "RecordedEventsCodec.h"
 #include <algorithm>
+#include <cstring>
 
 //==============================================================================
 JYPad::JYPad()
@@ -14,6 +16,9 @@ JYPad::JYPad()
         // 預設添加一個球
         DEBUG_LOG("JYPad: Adding default ball");
         addBall(1, 0.0f, 0.0f);
+        
+        // 啟動錄製擷取佇列的合併線程
+        recordingCapture = std::make_unique<RecordingCapture>(*this);
         DEBUG_LOG("JYPad: Constructor completed");
     }
     catch (const std::exception& e)
@@ -32,6 +37,8 @@ JYPad::JYPad()
 
 JYPad::~JYPad()
 {
+    // 先停止合併線程，避免它在錄製數據被銷毀後還在寫入
+    recordingCapture = nullptr;
 }
 
 //==============================================================================
@@ -55,6 +62,8 @@ void JYPad::processBlock([[maybe_unused]] juce::AudioBuffer<float>& buffer, [[ma
 //==============================================================================
 void JYPad::addBall(int ballId, float x, float y)
 {
+    const juce::ScopedLock lock(stateLock);
+    
     // 檢查是否已存在
     if (findBall(ballId) != nullptr)
         return;
@@ -64,10 +73,16 @@ void JYPad::addBall(int ballId, float x, float y)
     y = juce::jlimit(-1.0f, 1.0f, y);
 
     balls.emplace_back(ballId, x, y);
+
+    notifyBallLayoutChanged();
 }
 
 void JYPad::removeBall(int ballId)
 {
+    // 必須在取得 state lock 之前合併（合併線程的鎖順序是 merge lock -> state lock）
+    flushPendingRecordings();
+    const juce::ScopedLock lock(stateLock);
+    
     // 刪除球
     balls.erase(
         std::remove_if(balls.begin(), balls.end(),
@@ -76,11 +91,14 @@ void JYPad::removeBall(int ballId)
     );
     
     // 同時刪除該球的錄製事件數據
-    clearRecordedEvents(ballId);
+    eraseLane(ballId);
+
+    notifyBallLayoutChanged();
 }
 
 void JYPad::setBallPosition(int ballId, float x, float y)
 {
+    const juce::ScopedLock lock(stateLock);
     Ball* ball = findBall(ballId);
     if (ball != nullptr)
     {
@@ -102,11 +120,52 @@ void JYPad::setBallPosition(int ballId, float x, float y)
     }
 }
 
+void JYPad::clearBalls()
+{
+    const juce::ScopedLock lock(stateLock);
+    balls.clear();
+
+    notifyBallLayoutChanged();
+}
+
 Ball* JYPad::getBall(int ballId)
 {
     return findBall(ballId);
 }
 
+void JYPad::setBallOscPrefix(int ballId, const juce::String& prefix)
+{
+    const juce::ScopedLock lock(stateLock);
+    
+    if (Ball* ball = findBall(ballId))
+    {
+        ball->setOscPrefix(prefix);
+        
+        notifyBallLayoutChanged();
+    }
+}
+
+void JYPad::setBallRecording(int ballId, bool shouldRecord)
+{
+    const juce::ScopedLock lock(stateLock);
+    
+    Ball* ball = findBall(ballId);
+    if (ball == nullptr || ball->isRecording == shouldRecord)
+        return;
+    
+    ball->isRecording = shouldRecord;
+    
+    notifyBallLayoutChanged();
+}
+
+void JYPad::notifyBallLayoutChanged()
+{
+    ++ballLayoutRevision;
+
+    if (onBallLayoutChanged)
+        onBallLayoutChanged();
+}
+
 Ball* JYPad::findBall(int ballId)
 {
     auto it = std::find_if(balls.begin(), balls.end(),
@@ -136,8 +195,89 @@ juce::String JYPad::getBallOutputString(int ballId) const
 }
 
 //==============================================================================
+namespace
+{
+    // 舊 "RECM" 格式的單一事件：int ballId, double midiTime, float x, float y, float z（little-endian）
+    constexpr int legacyEventSize = 4 + 8 + 4 + 4 + 4;
+
+    float readLittleEndianFloat(const char* data) noexcept
+    {
+        const juce::uint32 bits = juce::ByteOrder::littleEndianInt(data);
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    double readLittleEndianDouble(const char* data) noexcept
+    {
+        const juce::uint64 bits = juce::ByteOrder::littleEndianInt64(data);
+        double value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    // 以區塊為單位讀取舊格式的事件並直接解碼到欄位，取代 lane 原本的內容
+    // 呼叫者必須先確認 stream 至少還有 numEvents * legacyEventSize bytes；返回略過的無效事件數
+    int readLegacyEventBlock(juce::InputStream& stream, int numEvents, EventLane& lane)
+    {
+        std::vector<double> times;
+        std::vector<float> xs, ys, zs;
+        times.reserve(static_cast<size_t>(numEvents));
+        xs.reserve(static_cast<size_t>(numEvents));
+        ys.reserve(static_cast<size_t>(numEvents));
+        zs.reserve(static_cast<size_t>(numEvents));
+
+        // 分段讀取，避免數百萬事件時一次配置整塊暫存
+        constexpr int eventsPerChunk = 16384;
+        juce::HeapBlock<char> chunk(static_cast<size_t>(eventsPerChunk) * legacyEventSize);
+        int numInvalid = 0;
+
+        for (int done = 0; done < numEvents;)
+        {
+            const int count = juce::jmin(eventsPerChunk, numEvents - done);
+            const int numBytes = count * legacyEventSize;
+
+            if (stream.read(chunk.getData(), numBytes) != numBytes)
+                break;
+
+            for (int j = 0; j < count; ++j)
+            {
+                // 逐事件的 ballId（前 4 bytes）是舊格式的冗餘欄位，lane 已經決定了所屬的球
+                const char* e = chunk.getData() + j * legacyEventSize;
+                const double midiTime = readLittleEndianDouble(e + 4);
+                const float x = readLittleEndianFloat(e + 12);
+                const float y = readLittleEndianFloat(e + 16);
+                const float z = readLittleEndianFloat(e + 20);
+
+                if (std::isfinite(midiTime) && std::isfinite(x) && std::isfinite(y) && std::isfinite(z))
+                {
+                    times.push_back(midiTime);
+                    xs.push_back(x);
+                    ys.push_back(y);
+                    zs.push_back(z);
+                }
+                else
+                {
+                    ++numInvalid;
+                }
+            }
+
+            done += count;
+        }
+
+        lane.assignColumns(std::move(times), std::move(xs), std::move(ys), std::move(zs));
+        return numInvalid;
+    }
+}
+
 void JYPad::saveState(juce::MemoryOutputStream& stream)
 {
+    // 確保還在擷取佇列中的錄製事件也被保存
+    flushPendingRecordings();
+    
+    // 合併線程與 OSC 輸入的擷取會在鎖內修改 recordedEvents，序列化期間不能被改動
+    const juce::ScopedLock lock(stateLock);
+    
     stream.writeInt(static_cast<int>(balls.size()));
     for (const auto& ball : balls)
     {
@@ -154,31 +294,24 @@ void JYPad::saveState(juce::MemoryOutputStream& stream)
     }
     
     // 保存錄製的事件數據
-    // 先寫入一個標記值，用於檢測是否有錄製事件數據（0x5245434D = "RECM" 的 ASCII）
-    // 這樣在載入時可以檢測是否是錄製事件數據
-    const int RECORDED_EVENTS_MARKER = 0x5245434D;  // "RECM"
-    stream.writeInt(RECORDED_EVENTS_MARKER);
-    stream.writeInt(static_cast<int>(recordedEvents.size()));
-    for (const auto& pair : recordedEvents)
-    {
-        int ballId = pair.first;
-        const auto& events = pair.second;
-        stream.writeInt(ballId);
-        stream.writeInt(static_cast<int>(events.size()));
-        for (const auto& event : events)
-        {
-            stream.writeInt(event.ballId);
-            stream.writeDouble(event.midiTime);
-            stream.writeFloat(event.x);
-            stream.writeFloat(event.y);
-            stream.writeFloat(event.z);
-        }
-    }
+    // 先寫入一個標記值，載入時用來判斷格式：
+    // "RECZ" 為差分/量化的壓縮格式（見 RecordedEventsCodec），舊版本寫入的 "RECM" 仍可載入
+    stream.writeInt(RecordedEventsCodec::marker);
+    RecordedEventsCodec::write(stream, recordedEvents);
 }
 
-void JYPad::loadState(juce::MemoryInputStream& stream)
+bool JYPad::loadState(juce::MemoryInputStream& stream)
 {
     DEBUG_LOG("JYPad: loadState started");
+    
+    // 先把舊的擷取事件合併掉，之後載入時會一併清除
+    flushPendingRecordings();
+    
+    const juce::ScopedLock lock(stateLock);
+    
+    // 球列表整個重建（不呼叫 onBallLayoutChanged，由呼叫端處理）
+    ++ballLayoutRevision;
+    
     try
     {
         balls.clear();
@@ -187,19 +320,19 @@ void JYPad::loadState(juce::MemoryInputStream& stream)
         if (stream.isExhausted())
         {
             DEBUG_LOG("JYPad: Stream is exhausted, no data to load");
-            return;
+            return true;
         }
         
         int numBalls = stream.readInt();
         DEBUG_LOG("JYPad: Loading " + juce::String(numBalls) + " balls");
         
-        // 檢查 numBalls 是否合理
-        if (numBalls < 0 || numBalls > 1000)
+        // 檢查 numBalls 是否合理：每個球至少有 id、x、y（12 bytes），不能超過剩餘的數據量
+        if (numBalls < 0 || static_cast<juce::int64>(numBalls) * 12 > stream.getNumBytesRemaining())
         {
             DEBUG_LOG_ERROR("JYPad: Invalid number of balls: " + juce::String(numBalls) + ", resetting");
             balls.clear();
             addBall(1, 0.0f, 0.0f);  // 添加預設球
-            return;
+            return false;
         }
         
         for (int i = 0; i < numBalls; ++i)
@@ -214,8 +347,8 @@ void JYPad::loadState(juce::MemoryInputStream& stream)
             int id = stream.readInt();
             DEBUG_LOG("JYPad: Reading ball " + juce::String(i) + ", id=" + juce::String(id));
             
-            // 檢查 ID 是否合理
-            if (id < 0 || id > 10000)
+            // 檢查 ID 是否合理（-1 代表「沒有球」）
+            if (id < 0)
             {
                 DEBUG_LOG_ERROR("JYPad: Invalid ball ID: " + juce::String(id) + ", skipping");
                 // 嘗試跳過這個球的數據，但這很危險，最好重置
@@ -332,6 +465,7 @@ void JYPad::loadState(juce::MemoryInputStream& stream)
         // 載入錄製的事件數據（如果存在）
         // 先清除舊的錄製事件，確保乾淨的狀態
         recordedEvents.clear();
+        ++laneLayoutRevision;
         
         // 檢查是否還有數據（可能是錄製事件數據，也可能是其他數據）
         // 為了安全，我們先嘗試讀取一個標記值
@@ -340,9 +474,21 @@ void JYPad::loadState(juce::MemoryInputStream& stream)
             try
             {
                 // 讀取標記值，用於檢測是否有錄製事件數據
-                const int RECORDED_EVENTS_MARKER = 0x5245434D;  // "RECM"
+                const int RECORDED_EVENTS_MARKER = 0x5245434D;  // "RECM"（舊格式）
                 int marker = stream.readInt();
                 
+                // 新的壓縮格式
+                if (marker == RecordedEventsCodec::marker)
+                {
+                    const auto result = RecordedEventsCodec::read(stream, recordedEvents);
+                    if (result != RecordedEventsCodec::ReadResult::loaded)
+                        recordedEvents.clear();
+                    
+                    ++laneLayoutRevision;
+                    DEBUG_LOG("JYPad: Loaded recorded events for " + juce::String(static_cast<int>(recordedEvents.size())) + " balls");
+                    return result != RecordedEventsCodec::ReadResult::streamCorrupt;
+                }
+                
                 // 如果標記不匹配，說明沒有錄製事件數據（可能是舊格式或其他數據）
                 if (marker != RECORDED_EVENTS_MARKER)
                 {
@@ -352,84 +498,40 @@ void JYPad::loadState(juce::MemoryInputStream& stream)
                     // 恢復 stream 位置，讓後續的 DataTable 正常處理
                     int64_t currentPos = stream.getPosition();
                     stream.setPosition(currentPos - 4);  // 回退 4 字節（一個 int）
-                    return;  // 提前返回，不載入錄製事件
+                    return true;  // 提前返回，不載入錄製事件
                 }
                 
                 // 標記匹配，繼續讀取錄製事件數量
                 int numBallsWithEvents = stream.readInt();
                 
-                // 驗證值的合理性（防止讀取到錯誤的數據）
-                if (numBallsWithEvents < 0 || numBallsWithEvents > 1000)
+                // 驗證值的合理性（防止讀取到錯誤的數據）：每個 lane 至少有 ballId 和事件數量（8 bytes）
+                if (numBallsWithEvents < 0 || static_cast<juce::int64>(numBallsWithEvents) * 8 > stream.getNumBytesRemaining())
                 {
                     DEBUG_LOG_ERROR("JYPad: Invalid numBallsWithEvents: " + juce::String(numBallsWithEvents));
-                    return;  // 提前返回，不載入錄製事件
+                    return false;  // 提前返回，不載入錄製事件
                 }
                 
                 for (int i = 0; i < numBallsWithEvents; ++i)
                 {
-                    if (stream.isExhausted())
-                        break;
-                    
                     int ballId = stream.readInt();
-                    if (stream.isExhausted())
-                        break;
-                    
                     int numEvents = stream.readInt();
                     
-                    // 驗證 numEvents 的合理性
-                    if (numEvents < 0 || numEvents > 100000)  // 最多 10 萬個事件
+                    // 驗證 numEvents 的合理性：不能超過剩餘的數據量
+                    if (numEvents < 0 || static_cast<juce::int64>(numEvents) * legacyEventSize > stream.getNumBytesRemaining())
                     {
                         DEBUG_LOG_ERROR("JYPad: Invalid numEvents: " + juce::String(numEvents) + " for ball " + juce::String(ballId));
-                        break;  // 跳過這個球的事件
+                        return false;  // 數據已損毀，停止載入後續的 lane
                     }
                     
-                    auto& events = recordedEvents[ballId];
-                    events.clear();
-                    events.reserve(numEvents);
+                    auto& lane = getOrCreateLane(ballId);
+                    lane.markModified();
                     
-                    for (int j = 0; j < numEvents; ++j)
-                    {
-                        if (stream.isExhausted())
-                        {
-                            DEBUG_LOG_ERROR("JYPad: Stream exhausted while reading event " + juce::String(j) + " for ball " + juce::String(ballId));
-                            break;
-                        }
-                        
-                        int eventBallId = stream.readInt();
-                        if (stream.isExhausted())
-                            break;
-                        
-                        double midiTime = stream.readDouble();
-                        if (stream.isExhausted())
-                            break;
-                        
-                        float x = stream.readFloat();
-                        if (stream.isExhausted())
-                            break;
-                        
-                        float y = stream.readFloat();
-                        if (stream.isExhausted())
-                            break;
-                        
-                        float z = stream.readFloat();
-                        
-                        // 驗證數據的合理性
-                        if (std::isfinite(midiTime) && std::isfinite(x) && std::isfinite(y) && std::isfinite(z))
-                        {
-                            events.emplace_back(eventBallId, midiTime, x, y, z);
-                        }
-                        else
-                        {
-                            DEBUG_LOG_ERROR("JYPad: Invalid event data (NaN/Inf) for ball " + juce::String(ballId));
-                            // 跳過這個無效事件
-                        }
-                    }
+                    const int numInvalid = readLegacyEventBlock(stream, numEvents, lane);
+                    if (numInvalid > 0)
+                        DEBUG_LOG_ERROR("JYPad: Skipped " + juce::String(numInvalid) + " invalid events (NaN/Inf) for ball " + juce::String(ballId));
                     
                     // 確保事件按時間排序
-                    if (!events.empty())
-                    {
-                        std::sort(events.begin(), events.end());
-                    }
+                    lane.sortByTime();
                 }
                 DEBUG_LOG("JYPad: Loaded recorded events for " + juce::String(numBallsWithEvents) + " balls");
             }
@@ -437,11 +539,13 @@ void JYPad::loadState(juce::MemoryInputStream& stream)
             {
                 DEBUG_LOG_ERROR("JYPad: Exception loading recorded events: " + juce::String(e.what()));
                 recordedEvents.clear();
+                return false;
             }
             catch (...)
             {
                 DEBUG_LOG("JYPad: Failed to load recorded events (unknown exception), using defaults");
                 recordedEvents.clear();
+                return false;
             }
         }
         else
@@ -456,6 +560,7 @@ void JYPad::loadState(juce::MemoryInputStream& stream)
         balls.clear();
         recordedEvents.clear();
         addBall(1, 0.0f, 0.0f);
+        return false;
     }
     catch (...)
     {
@@ -464,7 +569,10 @@ void JYPad::loadState(juce::MemoryInputStream& stream)
         balls.clear();
         recordedEvents.clear();
         addBall(1, 0.0f, 0.0f);
+        return false;
     }
+    
+    return true;
 }
 
 //==============================================================================
@@ -474,56 +582,109 @@ void JYPad::recordEvent(int ballId, double midiTime, float x, float y, float z)
     if (findBall(ballId) == nullptr)
         return;
     
-    // 添加事件到對應球的錄製序列
-    auto& events = recordedEvents[ballId];
+    // 只推入擷取佇列：拖動時不需要排序或重新配置記憶體
+    captureEvent(CaptureProducer::mouse, ballId, midiTime, x, y, z);
+}
+
+bool JYPad::captureEvent(CaptureProducer producer, int ballId, double midiTime, float x, float y, float z)
+{
+    if (recordingCapture == nullptr || !std::isfinite(midiTime))
+        return false;
     
-    // 檢查是否需要排序：只有當新事件的時間小於等於最後一個事件的時間時才需要排序
-    // 大多數情況下，錄製是按時間順序進行的，所以不需要排序
-    bool needsSort = false;
-    if (!events.empty())
+    CapturedEvent event;
+    event.ballId = ballId;
+    event.midiTime = midiTime;
+    event.x = x;
+    event.y = y;
+    event.z = z;
+    return recordingCapture->push(producer, event);
+}
+
+void JYPad::flushPendingRecordings()
+{
+    if (recordingCapture != nullptr)
+        recordingCapture->flush();
+}
+
+void JYPad::mergeCapturedEvents(const CapturedEvent* events, size_t numEvents)
+{
+    const juce::ScopedLock lock(stateLock);
+    
+    size_t runStart = 0;
+    while (runStart < numEvents)
     {
-        if (midiTime < events.back().midiTime)
+        // 找出同一個球的連續事件（已依時間排序）
+        const int ballId = events[runStart].ballId;
+        size_t runEnd = runStart + 1;
+        while (runEnd < numEvents && events[runEnd].ballId == ballId)
+            ++runEnd;
+        
+        // 球在擷取之後可能已被刪除
+        if (findBall(ballId) != nullptr)
         {
-            needsSort = true;
+            auto& lane = getOrCreateLane(ballId);
+            lane.markModified();
+            
+            // 合併已排序的一段事件（大多數情況下都在最後一個事件之後，直接附加）
+            const CapturedEvent* run = events + runStart;
+            lane.mergeSortedRun(runEnd - runStart, [run](size_t j) {
+                return RecordedEvent(run[j].midiTime, run[j].x, run[j].y, run[j].z);
+            });
         }
-    }
-    
-    // 執行插入（只插入一次！）
-    events.emplace_back(ballId, midiTime, x, y, z);
-    
-    // 只有在需要時才排序
-    if (needsSort)
-    {
-        std::sort(events.begin(), events.end());
+        
+        runStart = runEnd;
     }
 }
 
 void JYPad::clearRecordedEvents(int ballId)
 {
-    recordedEvents.erase(ballId);
+    flushPendingRecordings();
+    const juce::ScopedLock lock(stateLock);
+    eraseLane(ballId);
+}
+
+void JYPad::eraseLane(int ballId)
+{
+    if (recordedEvents.erase(ballId) > 0)
+        ++laneLayoutRevision;
 }
 
 void JYPad::clearAllRecordedEvents()
 {
+    flushPendingRecordings();
+    const juce::ScopedLock lock(stateLock);
     recordedEvents.clear();
+    ++laneLayoutRevision;
+}
+
+EventLane& JYPad::getOrCreateLane(int ballId)
+{
+    auto result = recordedEvents.try_emplace(ballId);
+    if (result.second)
+        ++laneLayoutRevision;  // 新增了 lane，讓游標重新綁定
+    return result.first->second;
 }
 
 void JYPad::insertEventAtTime(int ballId, double midiTime, float x, float y, float z)
 {
+    const juce::ScopedLock lock(stateLock);
+    
     // 檢查球是否存在
     if (findBall(ballId) == nullptr)
         return;
     
     // 添加事件到對應球的錄製序列
-    auto& events = recordedEvents[ballId];
-    events.emplace_back(ballId, midiTime, x, y, z);
+    auto& lane = getOrCreateLane(ballId);
+    lane.markModified();
     
-    // 保持按時間排序
-    std::sort(events.begin(), events.end());
+    // 以二分查找定位插入點並就地插入（不需要重新排序整個序列）
+    lane.insert(midiTime, x, y, z);
 }
 
 void JYPad::tweenToNext(int ballId, double currentMidiTime, int numSteps)
 {
+    const juce::ScopedLock lock(stateLock);
+    
     // 檢查球是否存在
     auto* ball = findBall(ballId);
     if (ball == nullptr)
@@ -533,28 +694,18 @@ void JYPad::tweenToNext(int ballId, double currentMidiTime, int numSteps)
     if (it == recordedEvents.end() || it->second.empty())
         return;
     
-    auto& events = it->second;
+    auto& lane = it->second;
     
     // 優化：使用二分查找找到第一個大於 currentMidiTime 的元素
-    // std::upper_bound 正好返回第一個大於 value 的元素 iterator
-    auto itEvent = std::upper_bound(events.begin(), events.end(), currentMidiTime,
-        [](double time, const RecordedEvent& event) {
-            return time < event.midiTime;
-        });
-        
-    const RecordedEvent* nextEvent = nullptr;
-    double nextTime = -1.0;
-    
-    if (itEvent != events.end())
-    {
-        nextEvent = &(*itEvent);
-        nextTime = nextEvent->midiTime;
-    }
+    const size_t nextIndex = lane.findFirstAfter(currentMidiTime);
     
     // 如果沒有下一個事件，無法進行插值
-    if (nextEvent == nullptr)
+    if (nextIndex >= lane.size())
         return;
     
+    const RecordedEvent nextEvent = lane.getEvent(nextIndex);
+    const double nextTime = nextEvent.midiTime;
+    
     // 使用當前球的位置作為起始點
     float startX = ball->x;
     float startY = ball->y;
@@ -566,104 +717,83 @@ void JYPad::tweenToNext(int ballId, double currentMidiTime, int numSteps)
         return;
     
     // 生成插值事件（從當前位置到下一個事件位置）
-    for (int i = 1; i < numSteps; ++i)
-    {
-        double t = static_cast<double>(i) / static_cast<double>(numSteps);
+    // 所有插值事件的時間都在 (currentMidiTime, nextTime) 之間，
+    // 會作為一段連續的已排序事件合併到下一個事件之前
+    if (numSteps <= 1)
+        return;
+    
+    lane.markModified();
+    lane.mergeSortedRun(static_cast<size_t>(numSteps - 1), [&](size_t j) {
+        double t = static_cast<double>(j + 1) / static_cast<double>(numSteps);
         double interpolatedTime = currentMidiTime + timeRange * t;
         
         // 線性插值位置（從當前球位置到下一個事件位置）
-        float x = startX + (nextEvent->x - startX) * static_cast<float>(t);
-        float y = startY + (nextEvent->y - startY) * static_cast<float>(t);
-        float z = startZ + (nextEvent->z - startZ) * static_cast<float>(t);
+        float x = startX + (nextEvent.x - startX) * static_cast<float>(t);
+        float y = startY + (nextEvent.y - startY) * static_cast<float>(t);
+        float z = startZ + (nextEvent.z - startZ) * static_cast<float>(t);
         
-        events.emplace_back(ballId, interpolatedTime, x, y, z);
-    }
-    
-    // 重新排序
-    std::sort(events.begin(), events.end());
+        return RecordedEvent(interpolatedTime, x, y, z);
+    });
 }
 
-const RecordedEvent* JYPad::getEventAtTime(int ballId, double midiTime) const
+std::optional<RecordedEvent> JYPad::getEventAtTime(int ballId, double midiTime) const
 {
     auto it = recordedEvents.find(ballId);
     if (it == recordedEvents.end() || it->second.empty())
-        return nullptr;
-    
-    const auto& events = it->second;
+        return std::nullopt;
     
-    // 優化：使用二分查找找到第一個大於 midiTime 的元素
-    // std::upper_bound 返回第一個大於 value 的元素
-    // 我們想要找的是 <= midiTime 的最後一個元素，所以應該是 upper_bound 的前一個
-    auto upper = std::upper_bound(events.begin(), events.end(), midiTime,
-        [](double time, const RecordedEvent& event) {
-            return time < event.midiTime;
-        });
+    // 優化：使用二分查找（只搜尋 time 欄位）找到 <= midiTime 的最後一個元素
+    const int index = it->second.findLastAtOrBefore(midiTime);
     
-    const RecordedEvent* closestEvent = nullptr;
+    // 如果所有元素都大於 midiTime，沒有符合條件的
+    if (index < 0)
+        return std::nullopt;
     
-    // 如果 upper 是 begin，表示所有元素都大於 midiTime，沒有符合條件的
-    if (upper != events.begin())
-    {
-        // upper 的前一個元素就是 <= midiTime 的最後一個元素（也是最大的那個）
-        closestEvent = &(*(upper - 1));
-    }
+    const RecordedEvent closestEvent = it->second.getEvent(static_cast<size_t>(index));
     
-    // 如果找到了事件，檢查位置是否與當前球的位置不同
-    if (closestEvent != nullptr)
+    // 檢查位置是否與當前球的位置不同
+    const Ball* ball = findBall(ballId);
+    if (ball != nullptr)
     {
-        const Ball* ball = findBall(ballId);
-        if (ball != nullptr)
+        // 只在位置改變時返回事件（節省資源）
+        const float epsilon = 0.0001f;  // 浮點數比較的容差
+        if (std::abs(ball->x - closestEvent.x) > epsilon ||
+            std::abs(ball->y - closestEvent.y) > epsilon)
         {
-            // 只在位置改變時返回事件（節省資源）
-            const float epsilon = 0.0001f;  // 浮點數比較的容差
-            if (std::abs(ball->x - closestEvent->x) > epsilon ||
-                std::abs(ball->y - closestEvent->y) > epsilon)
-            {
-                return closestEvent;
-            }
-        }
-        else
-        {
-            // 如果球不存在，仍然返回事件（可能球被刪除了但事件還在）
             return closestEvent;
         }
+        
+        return std::nullopt;
     }
     
-    return nullptr;  // 沒有找到合適的事件，返回 nullptr
+    // 如果球不存在，仍然返回事件（可能球被刪除了但事件還在）
+    return closestEvent;
 }
 
-const RecordedEvent* JYPad::getFirstEvent(int ballId) const
+std::optional<RecordedEvent> JYPad::getFirstEvent(int ballId) const
 {
     auto it = recordedEvents.find(ballId);
     if (it == recordedEvents.end() || it->second.empty())
-        return nullptr;
+        return std::nullopt;
     
     // 返回第一個事件（事件已按時間排序）
-    return &(it->second.front());
+    return it->second.getEvent(0);
 }
 
-const RecordedEvent* JYPad::getLastEventBeforeTime(int ballId, double midiTime) const
+std::optional<RecordedEvent> JYPad::getLastEventBeforeTime(int ballId, double midiTime) const
 {
     auto it = recordedEvents.find(ballId);
     if (it == recordedEvents.end() || it->second.empty())
-        return nullptr;
-    
-    const auto& events = it->second;
+        return std::nullopt;
     
     // 優化：使用二分查找代替線性搜索
     // 我們找 <= midiTime 的最後一個元素
-    auto upper = std::upper_bound(events.begin(), events.end(), midiTime,
-        [](double time, const RecordedEvent& event) {
-            return time < event.midiTime;
-        });
-        
-    if (upper != events.begin())
-    {
-        return &(*(upper - 1));
-    }
+    const int index = it->second.findLastAtOrBefore(midiTime);
+    if (index >= 0)
+        return it->second.getEvent(static_cast<size_t>(index));
     
-    // 如果所有事件的時間都大於 midiTime，返回 nullptr
-    return nullptr;
+    // 如果所有事件的時間都大於 midiTime，返回空值
+    return std::nullopt;
 }
 
 int JYPad::getRecordedEventCount(int ballId) const
@@ -673,3 +803,148 @@ int JYPad::getRecordedEventCount(int ballId) const
         return 0;
     return static_cast<int>(it->second.size());
 }
+
+const EventLane* JYPad::getLane(int ballId) const
+{
+    auto it = recordedEvents.find(ballId);
+    return (it != recordedEvents.end()) ? &(it->second) : nullptr;
+}
+
+std::vector<int> JYPad::getBallIdsWithEvents() const
+{
+    const juce::ScopedLock lock(stateLock);
+
+    std::vector<int> ballIds;
+    for (const auto& [ballId, lane] : recordedEvents)
+        if (!lane.empty())
+            ballIds.push_back(ballId);
+    return ballIds;
+}
+
+std::optional<EventLane> JYPad::copyLane(int ballId, juce::uint32& revision) const
+{
+    // 一次複製整個 lane 會長時間持有鎖，讓音訊線程的 ScopedTryLock 連續失敗；
+    // 改為分段複製，每段重新確認 revision，確保拼出來的是同一個版本
+    for (int attempt = 0; attempt < maxLaneCopyAttempts; ++attempt)
+    {
+        size_t numEvents = 0;
+        {
+            const juce::ScopedLock lock(stateLock);
+
+            auto it = recordedEvents.find(ballId);
+            if (it == recordedEvents.end())
+                return std::nullopt;
+
+            revision = it->second.getRevision();
+            numEvents = it->second.size();
+        }
+
+        // 在鎖外配置記憶體
+        std::vector<double> times(numEvents);
+        std::vector<float> xs(numEvents), ys(numEvents), zs(numEvents);
+
+        bool changed = false;
+        for (size_t start = 0; start < numEvents && !changed; start += laneCopyChunkSize)
+        {
+            const juce::ScopedLock lock(stateLock);
+
+            auto it = recordedEvents.find(ballId);
+            if (it == recordedEvents.end())
+                return std::nullopt;
+
+            const auto& lane = it->second;
+            if (lane.getRevision() != revision || lane.size() != numEvents)
+            {
+                changed = true;
+                break;
+            }
+
+            const size_t end = std::min(numEvents, start + laneCopyChunkSize);
+            std::copy(lane.getTimes().data + start, lane.getTimes().data + end, times.begin() + static_cast<std::ptrdiff_t>(start));
+            std::copy(lane.getXs().data + start, lane.getXs().data + end, xs.begin() + static_cast<std::ptrdiff_t>(start));
+            std::copy(lane.getYs().data + start, lane.getYs().data + end, ys.begin() + static_cast<std::ptrdiff_t>(start));
+            std::copy(lane.getZs().data + start, lane.getZs().data + end, zs.begin() + static_cast<std::ptrdiff_t>(start));
+        }
+
+        if (changed)
+            continue;
+
+        EventLane snapshot;
+        snapshot.assignColumns(std::move(times), std::move(xs), std::move(ys), std::move(zs));
+        return snapshot;
+    }
+
+    DEBUG_LOG("JYPad: Lane " + juce::String(ballId) + " kept changing while being copied");
+    return std::nullopt;
+}
+
+bool JYPad::retainLaneEvents(int ballId, juce::uint32 expectedRevision, const std::vector<size_t>& sortedIndices)
+{
+    const juce::ScopedLock lock(stateLock);
+
+    auto it = recordedEvents.find(ballId);
+    if (it == recordedEvents.end() || it->second.getRevision() != expectedRevision)
+        return false;
+
+    auto& lane = it->second;
+    if (sortedIndices.size() < lane.size())
+    {
+        lane.retain(sortedIndices);
+        lane.markModified();
+    }
+    return true;
+}
+
+//==============================================================================
+int PlaybackCursor::seek(const EventLane& lane, double midiTime)
+{
+    const auto times = lane.getTimes();
+    const int numEvents = static_cast<int>(times.size);
+    
+    // 順向播放且 lane 沒有被修改：從上次的位置線性前進
+    if (isValid && laneRevision == lane.getRevision() && midiTime >= lastTime && index < numEvents)
+    {
+        int steps = 0;
+        while (index + 1 < numEvents && times[static_cast<size_t>(index + 1)] <= midiTime)
+        {
+            ++index;
+            
+            if (++steps > maxLinearSteps)
+            {
+                // 跳得太遠，在剩下的範圍內二分查找
+                auto upper = std::upper_bound(times.begin() + index, times.end(), midiTime);
+                index = static_cast<int>(upper - times.begin()) - 1;
+                break;
+            }
+        }
+        
+        lastTime = midiTime;
+        return index;
+    }
+    
+    // seek / loop / lane 被修改：退回二分查找
+    index = lane.findLastAtOrBefore(midiTime);
+    lastTime = midiTime;
+    laneRevision = lane.getRevision();
+    isValid = true;
+    return index;
+}
+
+//==============================================================================
+void JYPad::resetBallsToFirstEventOrCenter()
+{
+    for (const auto& ball : balls)
+    {
+        const auto firstEvent = getFirstEvent(ball.id);
+        if (firstEvent.has_value())
+        {
+            // 有錄製數據，重置到第一個事件的位置
+            setBallPosition(ball.id, firstEvent->x, firstEvent->y);
+        }
+        else
+        {
+            // 沒有錄製數據，重置到中心 (0, 0)
+            setBallPosition(ball.id, 0.0f, 0.0f);
+        }
+    }
+}
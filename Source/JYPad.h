@@ -3,33 +3,40 @@
 #include <juce_core/juce_core.h>
 #include <juce_graphics/juce_graphics.h>
 #include <juce_audio_basics/juce_audio_basics.h>
+#include <atomic>
 #include <functional>
 #include <vector>
 #include <algorithm>
 #include <map>
+#include <optional>
 #include <unordered_map>
+#include "EventLane.h"
+#include "RecordingCapture.h"
+#include "OSCMessageTemplate.h"
 
 //==============================================================================
 /**
- * 錄製的事件
- * 記錄球的位置變化
+ * 回放游標
+ * 記住上一次找到的索引，順向播放時線性前進（攤提 O(1)），
+ * 只有在倒退（seek/loop）、跳得太遠或 lane 被修改時才退回二分查找。
  */
-struct RecordedEvent
+class PlaybackCursor
 {
-    int ballId;  // 球的 ID
-    double midiTime;  // PPQ position (MIDI time)
-    float x;
-    float y;
-    float z;  // 暫時為 0，未來擴展用
+public:
+    // 返回 <= midiTime 的最後一個事件索引，沒有則返回 -1
+    int seek(const EventLane& lane, double midiTime);
     
-    RecordedEvent(int id, double time, float xPos, float yPos, float zPos = 0.0f)
-        : ballId(id), midiTime(time), x(xPos), y(yPos), z(zPos) {}
+    // 下次 seek 時強制重新二分查找
+    void invalidate() noexcept { isValid = false; }
     
-    // 用於排序（按時間排序）
-    bool operator<(const RecordedEvent& other) const
-    {
-        return midiTime < other.midiTime;
-    }
+private:
+    int index = -1;
+    double lastTime = 0.0;
+    juce::uint32 laneRevision = 0;
+    bool isValid = false;
+    
+    // 線性前進超過這個步數就改用二分查找（大跳躍時避免 O(n)）
+    static constexpr int maxLinearSteps = 16;
 };
 
 //==============================================================================
@@ -46,7 +53,7 @@ struct Ball
     float y;  // 範圍: -1.0 到 1.0
     
     // Source 資訊
-    juce::String oscPrefix = "/track/1";  // 預設 prefix 為 /track/n
+    juce::String oscPrefix = "/track/1";  // 預設 prefix 為 /track/n（修改時使用 setOscPrefix()）
     juce::Colour color = juce::Colour(0xff4a90e2);  // 預設藍色
     juce::String sourceName = "";
     int sourceNumber = 1;  // 自動編號
@@ -58,13 +65,25 @@ struct Ball
     // Recording 狀態
     bool isRecording = false;
     
+    // 預先編碼的 {oscPrefix}/xy 訊息（"ff"），只在前綴改變時重建
+    OSCMessageTemplate xyMessage;
+    
     Ball(int ballId, float xPos = 0.0f, float yPos = 0.0f)
-        : uid(juce::Uuid()), id(ballId), x(xPos), y(yPos) {}
+        : uid(juce::Uuid()), id(ballId), x(xPos), y(yPos) { rebuildOSCTemplates(); }
     
     Ball(int ballId, float xPos, float yPos, const juce::String& prefix, 
          const juce::Colour& col, const juce::String& name, int number)
         : uid(juce::Uuid()), id(ballId), x(xPos), y(yPos), oscPrefix(prefix), color(col), 
-          sourceName(name), sourceNumber(number) {}
+          sourceName(name), sourceNumber(number) { rebuildOSCTemplates(); }
+    
+    void setOscPrefix(const juce::String& prefix)
+    {
+        oscPrefix = prefix;
+        rebuildOSCTemplates();
+    }
+    
+private:
+    void rebuildOSCTemplates() { xyMessage.set({ oscPrefix.toRawUTF8(), "/xy" }, "ff"); }
 };
 
 class JYPad
@@ -85,12 +104,20 @@ public:
     // 球體管理
     void addBall(int ballId, float x = 0.0f, float y = 0.0f);
     void removeBall(int ballId);
+    // 移動球（持有 state lock）：UI 拖動與回放 / OSC 輸入不會同時寫入位置與送出 OSC
+    // 音訊線程必須已經以 ScopedTryLock 持有 state lock（可重入，不會等待）
     void setBallPosition(int ballId, float x, float y);
     Ball* getBall(int ballId);
+    
+    // 修改球的 OSC 前綴（持有 state lock，音訊線程發送時不會讀到一半的樣板）
+    void setBallOscPrefix(int ballId, const juce::String& prefix);
+    
+    // 切換球的錄製狀態（OSC 輸入線程依此決定是否擷取該球的位置）
+    void setBallRecording(int ballId, bool shouldRecord);
     const std::vector<Ball>& getAllBalls() const { return balls; }
     std::vector<Ball>& getAllBalls() { return balls; }  // 非 const 版本，用於重置
     int getNumBalls() const { return static_cast<int>(balls.size()); }
-    void clearBalls() { balls.clear(); }  // 清除所有球
+    void clearBalls();  // 清除所有球
 
     // 座標轉換（UI 座標 <-> 邏輯座標）
     // UI 座標：0.0-1.0，邏輯座標：-1.0 到 1.0（中心為 0,0）
@@ -104,11 +131,25 @@ public:
 
     // 回調函數類型：當球移動時調用
     std::function<void(int ballId, float x, float y)> onBallMoved;
+    
+    // 回調函數：球被新增、刪除、OSC 前綴或錄製狀態改變時調用（持有 state lock）
+    std::function<void()> onBallLayoutChanged;
+    
+    // 球被新增、刪除、前綴或錄製狀態改變、或載入狀態時遞增（訊息線程讀取，用來更新快取）
+    juce::uint32 getBallLayoutRevision() const noexcept { return ballLayoutRevision.load(std::memory_order_relaxed); }
 
     // MIDI 錄製功能
     // 記錄球的位置變化（當球處於 recording 狀態且被拖動時）
+    // 只推入擷取佇列（wait-free），由背景線程合併進錄製數據
     void recordEvent(int ballId, double midiTime, float x, float y, float z = 0.0f);
     
+    // 從其他來源（OSC 輸入、腳本）擷取錄製事件，任何線程都可以呼叫（不需要鎖）
+    // 同一個 producer 同時只能有一個線程使用
+    bool captureEvent(CaptureProducer producer, int ballId, double midiTime, float x, float y, float z = 0.0f);
+    
+    // 把擷取佇列中尚未合併的事件立即合併（不能在持有 state lock 時呼叫）
+    void flushPendingRecordings();
+    
     // 清除指定球的錄製數據
     void clearRecordedEvents(int ballId);
     
@@ -121,33 +162,76 @@ public:
     // 在當前事件和下一個事件之間生成插值事件（Tween）
     void tweenToNext(int ballId, double currentMidiTime, int numSteps);
     
-    // 根據 MIDI time 回放錄製的事件（返回需要更新的球位置，如果沒有變化則返回 nullptr）
-    // 只在位置改變時返回，不動時返回 nullptr 以節省資源
-    const RecordedEvent* getEventAtTime(int ballId, double midiTime) const;
+    // 根據 MIDI time 回放錄製的事件（返回需要更新的球位置，如果沒有變化則返回空值）
+    // 只在位置改變時返回，不動時返回空值以節省資源
+    std::optional<RecordedEvent> getEventAtTime(int ballId, double midiTime) const;
     
     // 獲取指定球的第一個錄製事件（用於重置到初始位置）
-    const RecordedEvent* getFirstEvent(int ballId) const;
+    std::optional<RecordedEvent> getFirstEvent(int ballId) const;
     
     // 獲取指定時間點之前最後一個錄製事件（用於非播放狀態下的位置顯示）
-    const RecordedEvent* getLastEventBeforeTime(int ballId, double midiTime) const;
+    std::optional<RecordedEvent> getLastEventBeforeTime(int ballId, double midiTime) const;
     
     // 獲取指定球的錄製事件數量
     int getRecordedEventCount(int ballId) const;
+    
+    // 獲取指定球的錄製序列（沒有則返回 nullptr），供回放游標使用
+    // 返回的指針在 lane 佈局 revision 改變前有效（std::map 的節點不會搬移）
+    const EventLane* getLane(int ballId) const;
+    
+    // lane 被新增/刪除/全部清除時遞增
+    juce::uint32 getLaneLayoutRevision() const noexcept { return laneLayoutRevision; }
+
+    // 背景工作使用：有錄製數據的球 ID、分段複製 lane 的快照（連同 revision）
+    // 每段只短暫持有 state lock；複製途中 lane 被修改時重試，仍失敗或 lane 不存在時返回 nullopt
+    std::vector<int> getBallIdsWithEvents() const;
+    std::optional<EventLane> copyLane(int ballId, juce::uint32& revision) const;
+
+    // 只保留指定索引的事件；若 lane 在快照之後被修改過（revision 不同）則不套用並返回 false
+    bool retainLaneEvents(int ballId, juce::uint32 expectedRevision, const std::vector<size_t>& sortedIndices);
 
     // 狀態儲存/載入
     void saveState(juce::MemoryOutputStream& stream);
-    void loadState(juce::MemoryInputStream& stream);
+    // 返回 false 時 stream 停在損毀數據的中間，呼叫者不應再讀取之後的狀態
+    bool loadState(juce::MemoryInputStream& stream);
     
     // 重置所有球到第一個事件或中心
     void resetBallsToFirstEventOrCenter();
 
+    // 保護球列表結構與錄製數據的鎖
+    // UI 線程修改時持有；音訊線程（PlaybackEngine）只用 ScopedTryLock 讀取
+    const juce::CriticalSection& getStateLock() const noexcept { return stateLock; }
+
 private:
+    juce::CriticalSection stateLock;
     std::vector<Ball> balls;
     double currentSampleRate = 44100.0;
     int currentBlockSize = 512;
     
     // 錄製的事件數據：每個球 ID 對應一個事件序列（按時間排序）
-    std::map<int, std::vector<RecordedEvent>> recordedEvents;
+    std::map<int, EventLane> recordedEvents;
+    juce::uint32 laneLayoutRevision = 0;
+    
+    // copyLane 每次持有 state lock 複製的事件數，以及 lane 在複製途中被修改時的重試次數
+    static constexpr size_t laneCopyChunkSize = 4096;
+    static constexpr int maxLaneCopyAttempts = 3;
+    std::atomic<juce::uint32> ballLayoutRevision { 0 };
+    
+    // 遞增 ballLayoutRevision 並呼叫 onBallLayoutChanged（必須持有 state lock）
+    void notifyBallLayoutChanged();
+    
+    // 取得（必要時建立）指定球的 lane
+    EventLane& getOrCreateLane(int ballId);
+    
+    // 刪除指定球的 lane（必須持有 state lock）
+    void eraseLane(int ballId);
+    
+    // 錄製擷取佇列（最後宣告，確保合併線程在錄製數據之前被停止）
+    std::unique_ptr<RecordingCapture> recordingCapture;
+    
+    // 由 RecordingCapture 的合併線程呼叫，events 已依 (ballId, midiTime) 排序
+    friend class RecordingCapture;
+    void mergeCapturedEvents(const CapturedEvent* events, size_t numEvents);
 
     Ball* findBall(int ballId);
     const Ball* findBall(int ballId) const;
@@ -14,25 +14,8 @@ JYPadEditor::JYPadEditor(JYPad& pad, PlugDataCustomObjectAudioProcessor& process
         setMouseCursor(juce::MouseCursor::PointingHandCursor);
         DEBUG_LOG("JYPadEditor: Mouse cursor set - XY_STEP 3");
         
-        // 設定回調，當球移動時更新顯示（用於非拖曳情況，如程式化更新）
-        DEBUG_LOG("JYPadEditor: Setting up onBallMoved callback - XY_STEP 4");
-        jyPad.onBallMoved = [this]([[maybe_unused]] int ballId, [[maybe_unused]] float x, [[maybe_unused]] float y) {
-            // 如果不在拖曳狀態，才通過回調更新（拖曳時已經直接調用 repaint）
-            if (draggedBallId < 0)
-            {
-                if (juce::MessageManager::getInstance()->isThisTheMessageThread())
-                {
-                    repaint();
-                }
-                else
-                {
-                    juce::MessageManager::callAsync([this]() {
-                        repaint();
-                    });
-                }
-            }
-        };
-        DEBUG_LOG("JYPadEditor: Callback set - XY_STEP 5");
+        // 球移動時的重繪由 PluginEditor 的 timer 根據 Processor 的通知處理
+        // （回放可能在音訊線程中移動球，所以這裡不再設定 onBallMoved）
         
         DEBUG_LOG("JYPadEditor: Constructor completed successfully - XY_FINAL");
     }
@@ -394,7 +377,7 @@ void JYPadEditor::mouseDoubleClick(const juce::MouseEvent& e)
         auto* ball = jyPad.getBall(ballId);
         if (ball != nullptr)
         {
-            ball->isRecording = !ball->isRecording;
+            jyPad.setBallRecording(ballId, !ball->isRecording);
             repaint();
         }
     }
@@ -559,12 +542,15 @@ void JYPadEditor::showContextMenu(juce::Point<int> screenPosition, int ballId, j
             menu.addItem(7, "Clear Events");
             menu.addItem(8, "Set Position");
             menu.addItem(9, "Tween to next");
+            menu.addItem(10, "Simplify Events...", jyPad.getRecordedEventCount(ballId) > 2);
         }
     }
     else
     {
         // 在空白處右鍵：顯示 Add Source
         menu.addItem(3, "Add Source");
+        menu.addSeparator();
+        menu.addItem(11, "Simplify All Events...");
     }
     
     // 使用 withMousePosition() 確保選單在滑鼠位置顯示
@@ -596,29 +582,8 @@ void JYPadEditor::showContextMenu(juce::Point<int> screenPosition, int ballId, j
                                {
                                    ball->isMuted = !ball->isMuted;
                                    
-                                   // 發送 mute OSC 訊息
-                                   audioProcessor.sendMuteSoloOSCMessage(ballId, ball->isMuted, ball->isSoloed);
-                                   
-                                   // 如果有 solo 狀態，需要更新所有球的 OSC（因為 solo 會影響其他球）
-                                   const auto& allBalls = jyPad.getAllBalls();
-                                   bool hasSoloed = false;
-                                   for (const auto& b : allBalls)
-                                   {
-                                       if (b.isSoloed)
-                                       {
-                                           hasSoloed = true;
-                                           break;
-                                       }
-                                   }
-                                   
-                                   // 如果狀態改變影響了其他球，發送所有球的狀態
-                                   if (hasSoloed)
-                                   {
-                                       for (const auto& b : allBalls)
-                                       {
-                                           audioProcessor.sendMuteSoloOSCMessage(b.id, b.isMuted, b.isSoloed);
-                                       }
-                                   }
+                                   // 發送有效狀態改變的來源（solo 模式下 mute 只影響這個球）
+                                   audioProcessor.sendMuteSoloChanges();
                                    
                                    repaint();
                                }
@@ -631,15 +596,8 @@ void JYPadEditor::showContextMenu(juce::Point<int> screenPosition, int ballId, j
                                {
                                    ball->isSoloed = !ball->isSoloed;
                                    
-                                   // 發送 solo OSC 訊息
-                                   audioProcessor.sendMuteSoloOSCMessage(ballId, ball->isMuted, ball->isSoloed);
-                                   
-                                   // Solo 狀態改變會影響所有球，需要更新所有球的 OSC
-                                   const auto& allBalls = jyPad.getAllBalls();
-                                   for (const auto& b : allBalls)
-                                   {
-                                       audioProcessor.sendMuteSoloOSCMessage(b.id, b.isMuted, b.isSoloed);
-                                   }
+                                   // Solo 狀態改變會影響其他球，只送出有效狀態改變的來源
+                                   audioProcessor.sendMuteSoloChanges();
                                    
                                    repaint();
                                }
@@ -650,7 +608,7 @@ void JYPadEditor::showContextMenu(juce::Point<int> screenPosition, int ballId, j
                                auto* ball = jyPad.getBall(ballId);
                                if (ball != nullptr)
                                {
-                                   ball->isRecording = !ball->isRecording;
+                                   jyPad.setBallRecording(ballId, !ball->isRecording);
                                    repaint();
                                }
                            }
@@ -707,9 +665,60 @@ void JYPadEditor::showContextMenu(juce::Point<int> screenPosition, int ballId, j
                                    repaint();
                                }
                            }
+                           else if (result == 10)
+                           {
+                               // Simplify Events - 刪除誤差範圍內的多餘事件
+                               showSimplifyMenu({ ballId });
+                           }
+                           else if (result == 11)
+                           {
+                               // Simplify All Events
+                               showSimplifyMenu({});
+                           }
                        });
 }
 
+void JYPadEditor::showSimplifyMenu(std::vector<int> ballIds)
+{
+    auto* window = new juce::AlertWindow("Simplify Events",
+                                         "Remove recorded events that playback reproduces within the tolerance,\n"
+                                         "both with Step (hold last value) and Linear interpolation.\n"
+                                         "Tolerance is the maximum allowed position error (pad units, -1 to 1).",
+                                         juce::MessageBoxIconType::QuestionIcon, this);
+    window->addTextEditor("tolerance", "0.005", "Tolerance:");
+    window->addButton("OK", 1, juce::KeyPress(juce::KeyPress::returnKey));
+    window->addButton("Cancel", 0, juce::KeyPress(juce::KeyPress::escapeKey));
+    
+    juce::Component::SafePointer<JYPadEditor> safeThis(this);
+    
+    window->enterModalState(true, juce::ModalCallbackFunction::create(
+        [safeThis, window, ballIds](int result)
+        {
+            if (result != 1 || safeThis == nullptr)
+                return;
+            
+            const float tolerance = window->getTextEditorContents("tolerance").getFloatValue();
+            if (tolerance <= 0.0f)
+                return;
+            
+            // 在背景線程計算，完成後回到訊息線程顯示結果
+            safeThis->audioProcessor.simplifyRecordingsAsync(ballIds, tolerance,
+                [safeThis](const TrajectorySimplifier::Result& r)
+                {
+                    juce::String message = "Events: " + juce::String(static_cast<juce::int64>(r.eventsBefore))
+                                         + " -> " + juce::String(static_cast<juce::int64>(r.eventsAfter));
+                    if (r.lanesSkipped > 0)
+                        message << "\n" << r.lanesSkipped << " source(s) were edited during simplification and left unchanged.";
+                    
+                    juce::AlertWindow::showMessageBoxAsync(juce::MessageBoxIconType::InfoIcon,
+                                                           "Simplify Events", message);
+                    
+                    if (safeThis != nullptr)
+                        safeThis->repaint();
+                });
+        }), true);
+}
+
 void JYPadEditor::showAddSourceMenu(juce::Point<int> localPosition)
 {
     // 計算下一個 source number
@@ -750,7 +759,7 @@ void JYPadEditor::showAddSourceMenu(juce::Point<int> localPosition)
             auto* ball = jyPad.getBall(nextBallId);
             if (ball != nullptr)
             {
-                ball->oscPrefix = sourceInfo.oscPrefix;
+                jyPad.setBallOscPrefix(nextBallId, sourceInfo.oscPrefix);
                 ball->color = sourceInfo.color;
                 ball->sourceName = sourceInfo.sourceName;
                 ball->sourceNumber = sourceInfo.sourceNumber;
@@ -782,7 +791,7 @@ void JYPadEditor::showEditSourceMenu(int ballId)
             auto* ball = jyPad.getBall(ballId);
             if (ball != nullptr)
             {
-                ball->oscPrefix = sourceInfo.oscPrefix;
+                jyPad.setBallOscPrefix(ballId, sourceInfo.oscPrefix);
                 ball->color = sourceInfo.color;
                 ball->sourceName = sourceInfo.sourceName;
                 ball->sourceNumber = sourceInfo.sourceNumber;
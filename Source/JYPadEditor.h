@@ -36,6 +36,9 @@ public:
     void showAddSourceMenu(juce::Point<int> localPosition);
     void showEditSourceMenu(int ballId);
     void showDeleteConfirmMenu(int ballId);
+    
+    // 簡化錄製數據（ballIds 為空表示所有球）
+    void showSimplifyMenu(std::vector<int> ballIds);
 
     // 更新顯示
     void updateDisplay();
@@ -0,0 +1,46 @@
+#include "MuteSoloState.h"
+
+//==============================================================================
+void MuteSoloState::computeChanges(const std::vector<Ball>& balls, std::vector<Change>& changes)
+{
+    changes.clear();
+
+    if (needsFullResync.exchange(false))
+        lastSent.clear();
+
+    bool anySoloed = false;
+    for (const auto& ball : balls)
+        anySoloed = anySoloed || ball.isSoloed;
+
+    for (auto& entry : lastSent)
+        entry.second.isPresent = false;
+
+    for (const auto& ball : balls)
+    {
+        const bool isMuted = isEffectivelyMuted(ball, anySoloed);
+        auto [it, inserted] = lastSent.try_emplace(ball.id, SentState { isMuted, ball.isSoloed, true });
+
+        // 沒有送出過的來源（新的球或重新同步）兩個值都要送出
+        if (inserted)
+        {
+            changes.push_back({ ball.id, isMuted, ball.isSoloed, true, true });
+            continue;
+        }
+
+        auto& sent = it->second;
+        sent.isPresent = true;
+
+        const bool muteChanged = (sent.isMuted != isMuted);
+        const bool soloChanged = (sent.isSoloed != ball.isSoloed);
+        if (!muteChanged && !soloChanged)
+            continue;
+
+        sent.isMuted = isMuted;
+        sent.isSoloed = ball.isSoloed;
+        changes.push_back({ ball.id, isMuted, ball.isSoloed, muteChanged, soloChanged });
+    }
+
+    // 已刪除的球：之後以相同 ID 新增的球要重新送出
+    for (auto it = lastSent.begin(); it != lastSent.end();)
+        it = it->second.isPresent ? std::next(it) : lastSent.erase(it);
+}
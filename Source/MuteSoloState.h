@@ -0,0 +1,53 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <atomic>
+#include <unordered_map>
+#include <vector>
+#include "JYPad.h"
+
+//==============================================================================
+/**
+ * Mute/Solo 的有效狀態與差異
+ * 每個來源的有效狀態：被 mute，或有其他球 solo 而自己不是 solo 時為靜音。
+ * 記住上次送出的有效狀態，只返回改變的來源（以及改變的是哪一個值），
+ * 所以切換 mute 或 solo 時只送出實際改變的訊息，而不是每個球的 mute 與 solo。
+ *
+ * computeChanges() 只能由單一線程（訊息線程）呼叫；invalidate() 可以從任何線程呼叫。
+ */
+class MuteSoloState
+{
+public:
+    struct Change
+    {
+        int ballId;
+        bool isMuted;    // 有效的靜音狀態（包含 solo 的影響）
+        bool isSoloed;
+        bool muteChanged;
+        bool soloChanged;
+    };
+
+    // 有效的靜音狀態
+    static bool isEffectivelyMuted(const Ball& ball, bool anySoloed) noexcept
+    {
+        return ball.isMuted || (anySoloed && !ball.isSoloed);
+    }
+
+    // 以目前的球列表計算有效狀態，與上次送出的比較，把改變的來源寫入 changes
+    // 呼叫者必須持有 JYPad 的 stateLock；返回的改變視為已經送出
+    void computeChanges(const std::vector<Ball>& balls, std::vector<Change>& changes);
+
+    // 接收端的狀態未知（目的地改變、載入狀態）：下一次 computeChanges() 返回所有來源
+    void invalidate() noexcept { needsFullResync = true; }
+
+private:
+    struct SentState
+    {
+        bool isMuted;
+        bool isSoloed;
+        bool isPresent;  // 這次計算時球仍然存在（用來移除已刪除的球）
+    };
+
+    std::unordered_map<int, SentState> lastSent;
+    std::atomic<bool> needsFullResync { true };
+};
@@ -10,13 +10,13 @@ NetworkSettingsWindow::NetworkSettingsWindow(PlugDataCustomObjectAudioProcessor&
 {
     setUsingNativeTitleBar(true);
     setResizable(true, true);
-    setSize(400, 250);
+    setSize(400, 770);
     setAlwaysOnTop(true);  // 設定為 always on top
     
     // 創建內容元件
     auto* content = new juce::Component();
     setContentOwned(content, true);
-    content->setSize(400, 250);
+    content->setSize(400, 770);
     
     // OSC 設置區域
     oscGroup.setText("OSC Settings");
@@ -24,24 +24,75 @@ NetworkSettingsWindow::NetworkSettingsWindow(PlugDataCustomObjectAudioProcessor&
     oscGroup.setColour(juce::GroupComponent::textColourId, juce::Colours::white);
     content->addAndMakeVisible(&oscGroup);
     
+    // 目的地選擇（每個目的地有自己的地址、格式與頻率）
+    oscDestinationLabel.setText("Destination:", juce::dontSendNotification);
+    oscDestinationLabel.setColour(juce::Label::textColourId, juce::Colours::white);
+    oscDestinationLabel.setJustificationType(juce::Justification::centredLeft);
+    content->addAndMakeVisible(&oscDestinationLabel);
+    
+    oscDestinationBox.onChange = [this] {
+        const int index = oscDestinationBox.getSelectedItemIndex();
+        if (index >= 0)
+        {
+            selectedDestination = index;
+            loadSelectedDestination();
+            timerCallback();
+        }
+    };
+    content->addAndMakeVisible(&oscDestinationBox);
+    
+    oscAddDestinationButton.setButtonText("+");
+    oscAddDestinationButton.onClick = [this] {
+        {
+            juce::ScopedLock lock(audioProcessor.oscSettingsLock);
+            auto& destinations = audioProcessor.oscSettings.destinations;
+            if (static_cast<int>(destinations.size()) >= OSCTransmitter::maxDestinations)
+                return;
+            
+            // 新的目的地預設使用下一個 port
+            OSCDestination::Settings destination;
+            if (!destinations.empty())
+                destination.port = juce::jlimit(1, 65535, destinations.back().port + 1);
+            destinations.push_back(destination);
+            selectedDestination = static_cast<int>(destinations.size()) - 1;
+        }
+        audioProcessor.updateOSCConnection();
+        refreshDestinationList();
+        loadSelectedDestination();
+    };
+    content->addAndMakeVisible(&oscAddDestinationButton);
+    
+    oscRemoveDestinationButton.setButtonText("-");
+    oscRemoveDestinationButton.onClick = [this] {
+        {
+            juce::ScopedLock lock(audioProcessor.oscSettingsLock);
+            auto& destinations = audioProcessor.oscSettings.destinations;
+            
+            // 至少保留一個目的地
+            if (destinations.size() <= 1 || selectedDestination >= static_cast<int>(destinations.size()))
+                return;
+            
+            destinations.erase(destinations.begin() + selectedDestination);
+            selectedDestination = juce::jmin(selectedDestination, static_cast<int>(destinations.size()) - 1);
+        }
+        audioProcessor.updateOSCConnection();
+        refreshDestinationList();
+        loadSelectedDestination();
+    };
+    content->addAndMakeVisible(&oscRemoveDestinationButton);
+    
     // IP 地址設置
     oscIpLabel.setText("IP Address:", juce::dontSendNotification);
     oscIpLabel.setColour(juce::Label::textColourId, juce::Colours::white);
     oscIpLabel.setJustificationType(juce::Justification::centredLeft);
     content->addAndMakeVisible(&oscIpLabel);
     
-    {
-        juce::ScopedLock lock(audioProcessor.oscSettingsLock);
-        oscIpEditor.setText(audioProcessor.oscSettings.ipAddress, juce::dontSendNotification);
-    }
     oscIpEditor.setColour(juce::TextEditor::backgroundColourId, juce::Colour(0xff2a2a2a));
     oscIpEditor.setColour(juce::TextEditor::textColourId, juce::Colours::white);
     oscIpEditor.onTextChange = [this] {
-        {
-            juce::ScopedLock lock(audioProcessor.oscSettingsLock);
-            audioProcessor.oscSettings.ipAddress = oscIpEditor.getText();
-        }
-        audioProcessor.updateOSCConnection();
+        editSelectedDestination([this](OSCDestination::Settings& destination) {
+            destination.ipAddress = oscIpEditor.getText();
+        });
     };
     content->addAndMakeVisible(&oscIpEditor);
     
@@ -51,26 +102,29 @@ NetworkSettingsWindow::NetworkSettingsWindow(PlugDataCustomObjectAudioProcessor&
     oscPortLabel.setJustificationType(juce::Justification::centredLeft);
     content->addAndMakeVisible(&oscPortLabel);
     
-    {
-        juce::ScopedLock lock(audioProcessor.oscSettingsLock);
-        oscPortEditor.setText(juce::String(audioProcessor.oscSettings.port), juce::dontSendNotification);
-    }
     oscPortEditor.setColour(juce::TextEditor::backgroundColourId, juce::Colour(0xff2a2a2a));
     oscPortEditor.setColour(juce::TextEditor::textColourId, juce::Colours::white);
     oscPortEditor.onTextChange = [this] {
         int port = oscPortEditor.getText().getIntValue();
         if (port > 0 && port < 65536)
         {
-            {
-                juce::ScopedLock lock(audioProcessor.oscSettingsLock);
-                audioProcessor.oscSettings.port = port;
-            }
-            audioProcessor.updateOSCConnection();
+            editSelectedDestination([port](OSCDestination::Settings& destination) {
+                destination.port = port;
+            });
         }
     };
     content->addAndMakeVisible(&oscPortEditor);
     
-    // 啟用/停用 OSC
+    // 目的地的啟用/停用
+    oscDestinationEnabledButton.setButtonText("Active");
+    oscDestinationEnabledButton.onClick = [this] {
+        editSelectedDestination([this](OSCDestination::Settings& destination) {
+            destination.enabled = oscDestinationEnabledButton.getToggleState();
+        });
+    };
+    content->addAndMakeVisible(&oscDestinationEnabledButton);
+    
+    // 啟用/停用 OSC（所有目的地的總開關）
     oscEnabledButton.setButtonText("Enable OSC");
     {
         juce::ScopedLock lock(audioProcessor.oscSettingsLock);
@@ -85,6 +139,48 @@ NetworkSettingsWindow::NetworkSettingsWindow(PlugDataCustomObjectAudioProcessor&
     };
     content->addAndMakeVisible(&oscEnabledButton);
     
+    // 完整狀態刷新（ID 為 Hz 乘以 10，1 表示關閉）：定期重送所有球的位置，讓接收端從遺失的封包中恢復
+    oscRefreshLabel.setText("Refresh:", juce::dontSendNotification);
+    oscRefreshLabel.setColour(juce::Label::textColourId, juce::Colours::white);
+    oscRefreshLabel.setJustificationType(juce::Justification::centredLeft);
+    content->addAndMakeVisible(&oscRefreshLabel);
+    
+    oscRefreshBox.addItem("Off", 1);
+    for (double rateHz : { 0.5, 1.0, 2.0, 5.0, 10.0 })
+        oscRefreshBox.addItem(juce::String(rateHz, rateHz < 1.0 ? 1 : 0) + " Hz", juce::roundToInt(rateHz * 10.0));
+    
+    double currentRefreshRate = 0.0;
+    {
+        juce::ScopedLock lock(audioProcessor.oscSettingsLock);
+        currentRefreshRate = audioProcessor.oscSettings.refreshRateHz;
+    }
+    const int currentRefreshId = juce::roundToInt(currentRefreshRate * 10.0);
+    oscRefreshBox.setSelectedId(currentRefreshId > 1 ? currentRefreshId : 1, juce::dontSendNotification);
+    if (oscRefreshBox.getSelectedId() == 0)
+    {
+        // 狀態中保存的頻率不在列表中
+        oscRefreshBox.addItem(juce::String(currentRefreshRate, 1) + " Hz", currentRefreshId);
+        oscRefreshBox.setSelectedId(currentRefreshId, juce::dontSendNotification);
+    }
+    oscRefreshBox.onChange = [this] {
+        const int id = oscRefreshBox.getSelectedId();
+        {
+            juce::ScopedLock lock(audioProcessor.oscSettingsLock);
+            audioProcessor.oscSettings.refreshRateHz = id > 1 ? id / 10.0 : 0.0;
+        }
+        audioProcessor.updateOSCConnection();
+    };
+    content->addAndMakeVisible(&oscRefreshBox);
+    
+    // Bundle 模式：每個更新 tick 的所有位置合併成一個帶 timetag 的 bundle
+    oscBundleButton.setButtonText("Bundle per tick");
+    oscBundleButton.onClick = [this] {
+        editSelectedDestination([this](OSCDestination::Settings& destination) {
+            destination.bundleMode = oscBundleButton.getToggleState();
+        });
+    };
+    content->addAndMakeVisible(&oscBundleButton);
+    
     // 測試按鈕
     oscTestButton.setButtonText("Test");
     oscTestButton.onClick = [this] {
@@ -93,13 +189,239 @@ NetworkSettingsWindow::NetworkSettingsWindow(PlugDataCustomObjectAudioProcessor&
     };
     content->addAndMakeVisible(&oscTestButton);
     
+    // 最大發送頻率（ID 即為 Hz，1 表示不限制）：超過時每個球只送出最新的位置
+    oscMaxRateLabel.setText("Max Rate:", juce::dontSendNotification);
+    oscMaxRateLabel.setColour(juce::Label::textColourId, juce::Colours::white);
+    oscMaxRateLabel.setJustificationType(juce::Justification::centredLeft);
+    content->addAndMakeVisible(&oscMaxRateLabel);
+    
+    oscMaxRateBox.onChange = [this] {
+        const int id = oscMaxRateBox.getSelectedId();
+        editSelectedDestination([id](OSCDestination::Settings& destination) {
+            destination.maxRateHz = id > 1 ? static_cast<double>(id) : 0.0;
+        });
+    };
+    content->addAndMakeVisible(&oscMaxRateBox);
+    
+    // Lookahead：回放位置提前送出，由接收端依 timetag 套用（需要 bundle 模式且不限制頻率）
+    oscLookaheadButton.setButtonText("Lookahead");
+    oscLookaheadButton.onClick = [this] {
+        editSelectedDestination([this](OSCDestination::Settings& destination) {
+            destination.lookahead = oscLookaheadButton.getToggleState();
+        });
+    };
+    content->addAndMakeVisible(&oscLookaheadButton);
+    
+    // 重新連線期間保留佇列中的封包，恢復後送出（否則丟棄，只送出恢復後的新位置）
+    oscHoldButton.setButtonText("Hold");
+    oscHoldButton.onClick = [this] {
+        editSelectedDestination([this](OSCDestination::Settings& destination) {
+            destination.holdWhileReconnecting = oscHoldButton.getToggleState();
+        });
+    };
+    content->addAndMakeVisible(&oscHoldButton);
+    
+    refreshDestinationList();
+    loadSelectedDestination();
+    
+    // 發送統計
+    oscStatsLabel.setColour(juce::Label::textColourId, juce::Colours::grey);
+    oscStatsLabel.setJustificationType(juce::Justification::centredLeft);
+    oscStatsLabel.setFont(juce::Font(11.0f));
+    content->addAndMakeVisible(&oscStatsLabel);
+    
+    // 每秒把每個目的地自己的統計以 /jypad/stats 送過去（監控或調整頻率限制用）
+    oscPublishStatsButton.setButtonText("Publish /jypad/stats");
+    {
+        juce::ScopedLock lock(audioProcessor.oscSettingsLock);
+        oscPublishStatsButton.setToggleState(audioProcessor.oscSettings.publishStats, juce::dontSendNotification);
+    }
+    oscPublishStatsButton.onClick = [this] {
+        {
+            juce::ScopedLock lock(audioProcessor.oscSettingsLock);
+            audioProcessor.oscSettings.publishStats = oscPublishStatsButton.getToggleState();
+        }
+        audioProcessor.updateOSCConnection();
+    };
+    content->addAndMakeVisible(&oscPublishStatsButton);
+    
+    // OSC 輸入區域：接收 {osc_prefix}/xy x y 來移動對應的球
+    inputGroup.setText("OSC Input");
+    inputGroup.setColour(juce::GroupComponent::outlineColourId, juce::Colour(0xff404040));
+    inputGroup.setColour(juce::GroupComponent::textColourId, juce::Colours::white);
+    content->addAndMakeVisible(&inputGroup);
+    
+    inputPortLabel.setText("Port:", juce::dontSendNotification);
+    inputPortLabel.setColour(juce::Label::textColourId, juce::Colours::white);
+    inputPortLabel.setJustificationType(juce::Justification::centredLeft);
+    content->addAndMakeVisible(&inputPortLabel);
+    
+    {
+        juce::ScopedLock lock(audioProcessor.oscSettingsLock);
+        inputPortEditor.setText(juce::String(audioProcessor.oscSettings.inputPort), juce::dontSendNotification);
+        inputEnabledButton.setToggleState(audioProcessor.oscSettings.inputEnabled, juce::dontSendNotification);
+    }
+    inputPortEditor.setColour(juce::TextEditor::backgroundColourId, juce::Colour(0xff2a2a2a));
+    inputPortEditor.setColour(juce::TextEditor::textColourId, juce::Colours::white);
+    inputPortEditor.onTextChange = [this] {
+        int port = inputPortEditor.getText().getIntValue();
+        if (port > 0 && port < 65536)
+        {
+            {
+                juce::ScopedLock lock(audioProcessor.oscSettingsLock);
+                audioProcessor.oscSettings.inputPort = port;
+            }
+            audioProcessor.updateOSCConnection();
+        }
+    };
+    content->addAndMakeVisible(&inputPortEditor);
+    
+    inputEnabledButton.setButtonText("Listen");
+    inputEnabledButton.onClick = [this] {
+        {
+            juce::ScopedLock lock(audioProcessor.oscSettingsLock);
+            audioProcessor.oscSettings.inputEnabled = inputEnabledButton.getToggleState();
+        }
+        audioProcessor.updateOSCConnection();
+    };
+    content->addAndMakeVisible(&inputEnabledButton);
+    
+    inputStatsLabel.setColour(juce::Label::textColourId, juce::Colours::grey);
+    inputStatsLabel.setJustificationType(juce::Justification::centredLeft);
+    inputStatsLabel.setFont(juce::Font(11.0f));
+    content->addAndMakeVisible(&inputStatsLabel);
+    
+    // 回放設置區域
+    playbackGroup.setText("Playback");
+    playbackGroup.setColour(juce::GroupComponent::outlineColourId, juce::Colour(0xff404040));
+    playbackGroup.setColour(juce::GroupComponent::textColourId, juce::Colours::white);
+    content->addAndMakeVisible(&playbackGroup);
+    
+    // 插值模式
+    interpolationLabel.setText("Interpolation:", juce::dontSendNotification);
+    interpolationLabel.setColour(juce::Label::textColourId, juce::Colours::white);
+    interpolationLabel.setJustificationType(juce::Justification::centredLeft);
+    content->addAndMakeVisible(&interpolationLabel);
+    
+    for (int i = 0; i < static_cast<int>(TrajectoryInterpolator::Mode::numModes); ++i)
+        interpolationBox.addItem(TrajectoryInterpolator::getModeName(static_cast<TrajectoryInterpolator::Mode>(i)), i + 1);
+    interpolationBox.setSelectedId(static_cast<int>(audioProcessor.playbackEngine.getInterpolationMode()) + 1, juce::dontSendNotification);
+    interpolationBox.onChange = [this] {
+        audioProcessor.playbackEngine.setInterpolationMode(
+            static_cast<TrajectoryInterpolator::Mode>(interpolationBox.getSelectedId() - 1));
+    };
+    content->addAndMakeVisible(&interpolationBox);
+    
+    // 輸出頻率（ID 即為 Hz，1 表示每個 audio block 一次）
+    outputRateLabel.setText("Output Rate:", juce::dontSendNotification);
+    outputRateLabel.setColour(juce::Label::textColourId, juce::Colours::white);
+    outputRateLabel.setJustificationType(juce::Justification::centredLeft);
+    content->addAndMakeVisible(&outputRateLabel);
+    
+    outputRateBox.addItem("Per audio block", 1);
+    for (int rateHz : { 100, 200, 250, 500, 1000 })
+        outputRateBox.addItem(juce::String(rateHz) + " Hz", rateHz);
+    
+    const int currentRate = juce::roundToInt(audioProcessor.playbackEngine.getOutputRateHz());
+    outputRateBox.setSelectedId(currentRate > 1 ? currentRate : 1, juce::dontSendNotification);
+    if (outputRateBox.getSelectedId() == 0)
+    {
+        // 狀態中保存的頻率不在列表中
+        outputRateBox.addItem(juce::String(currentRate) + " Hz", currentRate);
+        outputRateBox.setSelectedId(currentRate, juce::dontSendNotification);
+    }
+    outputRateBox.onChange = [this] {
+        const int id = outputRateBox.getSelectedId();
+        audioProcessor.playbackEngine.setOutputRateHz(id > 1 ? static_cast<double>(id) : 0.0);
+    };
+    content->addAndMakeVisible(&outputRateBox);
+    
+    // 提前排程的時間（ID 即為毫秒，1 表示關閉）：只影響啟用 Lookahead 的目的地
+    lookaheadLabel.setText("Lookahead:", juce::dontSendNotification);
+    lookaheadLabel.setColour(juce::Label::textColourId, juce::Colours::white);
+    lookaheadLabel.setJustificationType(juce::Justification::centredLeft);
+    content->addAndMakeVisible(&lookaheadLabel);
+    
+    lookaheadBox.addItem("Off", 1);
+    for (int milliseconds : { 10, 20, 50, 100, 200, 500 })
+        lookaheadBox.addItem(juce::String(milliseconds) + " ms", milliseconds);
+    
+    const int currentLookahead = juce::roundToInt(audioProcessor.playbackEngine.getLookaheadMs());
+    lookaheadBox.setSelectedId(currentLookahead > 1 ? currentLookahead : 1, juce::dontSendNotification);
+    if (lookaheadBox.getSelectedId() == 0)
+    {
+        // 狀態中保存的時間不在列表中
+        lookaheadBox.addItem(juce::String(currentLookahead) + " ms", currentLookahead);
+        lookaheadBox.setSelectedId(currentLookahead, juce::dontSendNotification);
+    }
+    lookaheadBox.onChange = [this] {
+        const int id = lookaheadBox.getSelectedId();
+        audioProcessor.playbackEngine.setLookaheadMs(id > 1 ? static_cast<double>(id) : 0.0);
+    };
+    content->addAndMakeVisible(&lookaheadBox);
+    
+    // 擷取區域：把每個送出的封包與時間戳寫入檔案，之後可以重送到本機的接收端
+    captureGroup.setText("Capture");
+    captureGroup.setColour(juce::GroupComponent::outlineColourId, juce::Colour(0xff404040));
+    captureGroup.setColour(juce::GroupComponent::textColourId, juce::Colours::white);
+    content->addAndMakeVisible(&captureGroup);
+    
+    captureButton.onClick = [this] {
+        auto& writer = audioProcessor.oscTransmitter.getCaptureWriter();
+        if (writer.isCapturing())
+            writer.stop();
+        else
+            chooseCaptureFile();
+        updateCaptureStatus();
+    };
+    content->addAndMakeVisible(&captureButton);
+    
+    captureStatusLabel.setColour(juce::Label::textColourId, juce::Colours::grey);
+    captureStatusLabel.setJustificationType(juce::Justification::centredLeft);
+    captureStatusLabel.setFont(juce::Font(11.0f));
+    content->addAndMakeVisible(&captureStatusLabel);
+    
+    // 重送目前選擇的目的地擷取到的封包
+    replayButton.onClick = [this] {
+        if (captureReplayer.isReplaying())
+            captureReplayer.stop();
+        else
+            chooseReplayFile();
+        updateCaptureStatus();
+    };
+    content->addAndMakeVisible(&replayButton);
+    
+    replayFastButton.setButtonText("Fast");
+    content->addAndMakeVisible(&replayFastButton);
+    
+    replayPortLabel.setText("Port:", juce::dontSendNotification);
+    replayPortLabel.setColour(juce::Label::textColourId, juce::Colours::white);
+    replayPortLabel.setJustificationType(juce::Justification::centredLeft);
+    content->addAndMakeVisible(&replayPortLabel);
+    
+    replayPortEditor.setText(juce::String(OSCDestination::Settings().port), juce::dontSendNotification);
+    replayPortEditor.setColour(juce::TextEditor::backgroundColourId, juce::Colour(0xff2a2a2a));
+    replayPortEditor.setColour(juce::TextEditor::textColourId, juce::Colours::white);
+    replayPortEditor.setInputRestrictions(5, "0123456789");
+    content->addAndMakeVisible(&replayPortEditor);
+    
+    replayStatusLabel.setColour(juce::Label::textColourId, juce::Colours::grey);
+    replayStatusLabel.setJustificationType(juce::Justification::centredLeft);
+    replayStatusLabel.setFont(juce::Font(11.0f));
+    content->addAndMakeVisible(&replayStatusLabel);
+    
     // 設定內容元件的佈局
-    content->setBounds(0, 0, 400, 250);
+    content->setBounds(0, 0, 400, 770);
     layoutContent(content);
+    
+    timerCallback();
+    startTimer(500);
 }
 
 NetworkSettingsWindow::~NetworkSettingsWindow()
 {
+    stopTimer();
+    captureReplayer.stop();
 }
 
 //==============================================================================
@@ -114,11 +436,32 @@ void NetworkSettingsWindow::layoutContent(juce::Component* content)
     auto area = content->getLocalBounds().reduced(20);
     
     // OSC 設置區域
-    auto oscArea = area.removeFromTop(180);
+    auto oscArea = area.removeFromTop(315);
     oscGroup.setBounds(oscArea);
     
     auto oscContent = oscArea.reduced(15, 25);
     
+    // 總開關與目的地選擇
+    auto masterRow = oscContent.removeFromTop(25);
+    oscEnabledButton.setBounds(masterRow.removeFromLeft(100));
+    masterRow.removeFromLeft(10);
+    oscTestButton.setBounds(masterRow.removeFromLeft(60));
+    masterRow.removeFromLeft(10);
+    oscRefreshLabel.setBounds(masterRow.removeFromLeft(60));
+    oscRefreshBox.setBounds(masterRow.removeFromLeft(90));
+    
+    oscContent.removeFromTop(5);
+    
+    auto destinationRow = oscContent.removeFromTop(25);
+    oscDestinationLabel.setBounds(destinationRow.removeFromLeft(80));
+    oscDestinationBox.setBounds(destinationRow.removeFromLeft(170));
+    destinationRow.removeFromLeft(5);
+    oscAddDestinationButton.setBounds(destinationRow.removeFromLeft(30));
+    destinationRow.removeFromLeft(5);
+    oscRemoveDestinationButton.setBounds(destinationRow.removeFromLeft(30));
+    
+    oscContent.removeFromTop(10);
+    
     // IP 地址
     auto ipRow = oscContent.removeFromTop(25);
     oscIpLabel.setBounds(ipRow.removeFromLeft(80));
@@ -131,12 +474,324 @@ void NetworkSettingsWindow::layoutContent(juce::Component* content)
     oscPortLabel.setBounds(portRow.removeFromLeft(80));
     oscPortEditor.setBounds(portRow.removeFromLeft(100));
     
+    oscContent.removeFromTop(5);
+    
+    // 最大發送頻率
+    auto maxRateRow = oscContent.removeFromTop(25);
+    oscMaxRateLabel.setBounds(maxRateRow.removeFromLeft(80));
+    oscMaxRateBox.setBounds(maxRateRow.removeFromLeft(120));
+    maxRateRow.removeFromLeft(10);
+    oscLookaheadButton.setBounds(maxRateRow.removeFromLeft(100));
+    
     oscContent.removeFromTop(10);
     
-    // 按鈕
+    // 目的地的選項
     auto buttonRow = oscContent.removeFromTop(25);
-    oscEnabledButton.setBounds(buttonRow.removeFromLeft(100));
+    oscDestinationEnabledButton.setBounds(buttonRow.removeFromLeft(100));
     buttonRow.removeFromLeft(10);
-    oscTestButton.setBounds(buttonRow.removeFromLeft(60));
+    oscBundleButton.setBounds(buttonRow.removeFromLeft(130));
+    buttonRow.removeFromLeft(10);
+    oscHoldButton.setBounds(buttonRow.removeFromLeft(80));
+    
+    oscContent.removeFromTop(5);
+    oscPublishStatsButton.setBounds(oscContent.removeFromTop(25).removeFromLeft(200));
+    oscStatsLabel.setBounds(oscContent.removeFromTop(45));
+    
+    area.removeFromTop(10);
+    
+    // OSC 輸入區域
+    auto inputArea = area.removeFromTop(110);
+    inputGroup.setBounds(inputArea);
+    
+    auto inputContent = inputArea.reduced(15, 25);
+    
+    auto inputRow = inputContent.removeFromTop(25);
+    inputPortLabel.setBounds(inputRow.removeFromLeft(80));
+    inputPortEditor.setBounds(inputRow.removeFromLeft(100));
+    inputRow.removeFromLeft(10);
+    inputEnabledButton.setBounds(inputRow.removeFromLeft(100));
+    
+    inputContent.removeFromTop(5);
+    inputStatsLabel.setBounds(inputContent.removeFromTop(30));
+    
+    area.removeFromTop(10);
+    
+    // 回放設置區域
+    auto playbackArea = area.removeFromTop(130);
+    playbackGroup.setBounds(playbackArea);
+    
+    auto playbackContent = playbackArea.reduced(15, 25);
+    
+    auto interpolationRow = playbackContent.removeFromTop(25);
+    interpolationLabel.setBounds(interpolationRow.removeFromLeft(100));
+    interpolationBox.setBounds(interpolationRow.removeFromLeft(160));
+    
+    playbackContent.removeFromTop(5);
+    
+    auto rateRow = playbackContent.removeFromTop(25);
+    outputRateLabel.setBounds(rateRow.removeFromLeft(100));
+    outputRateBox.setBounds(rateRow.removeFromLeft(160));
+    
+    playbackContent.removeFromTop(5);
+    
+    auto lookaheadRow = playbackContent.removeFromTop(25);
+    lookaheadLabel.setBounds(lookaheadRow.removeFromLeft(100));
+    lookaheadBox.setBounds(lookaheadRow.removeFromLeft(160));
+    
+    area.removeFromTop(10);
+    
+    // 擷取區域
+    auto captureArea = area.removeFromTop(130);
+    captureGroup.setBounds(captureArea);
+    
+    auto captureContent = captureArea.reduced(15, 25);
+    
+    auto captureRow = captureContent.removeFromTop(25);
+    captureButton.setBounds(captureRow.removeFromLeft(100));
+    captureRow.removeFromLeft(10);
+    captureStatusLabel.setBounds(captureRow);
+    
+    captureContent.removeFromTop(5);
+    
+    auto replayRow = captureContent.removeFromTop(25);
+    replayButton.setBounds(replayRow.removeFromLeft(100));
+    replayRow.removeFromLeft(10);
+    replayFastButton.setBounds(replayRow.removeFromLeft(70));
+    replayRow.removeFromLeft(10);
+    replayPortLabel.setBounds(replayRow.removeFromLeft(40));
+    replayPortEditor.setBounds(replayRow.removeFromLeft(70));
+    
+    captureContent.removeFromTop(5);
+    replayStatusLabel.setBounds(captureContent.removeFromTop(20));
 }
 
+void NetworkSettingsWindow::timerCallback()
+{
+    updateCaptureStatus();
+    
+    // OSC 輸入統計
+    const auto& input = audioProcessor.oscInput;
+    if (input.isEnabled() && !input.isBound())
+    {
+        inputStatsLabel.setText("Not listening (port unavailable)", juce::dontSendNotification);
+    }
+    else
+    {
+        // 第二行：抖動緩衝的估計值（所有來源中最差的）
+        const auto jitter = input.getJitterStats();
+        inputStatsLabel.setText("Packets: " + juce::String(static_cast<juce::int64>(input.getNumPacketsReceived()))
+                                + "  Positions: " + juce::String(static_cast<juce::int64>(input.getNumPositionsReceived()))
+                                + "  Ignored: " + juce::String(static_cast<juce::int64>(input.getNumIgnoredMessages() + input.getNumMalformedPackets()))
+                                + "\nJitter: " + juce::String(jitter.maxJitterMs, 1) + " ms"
+                                + "  Delay: " + juce::String(jitter.maxPlayoutDelayMs, 1) + " ms"
+                                + "  Rate: " + juce::String(jitter.maxRateHz, 0) + " Hz"
+                                + "  Underruns: " + juce::String(static_cast<juce::int64>(input.getNumUnderruns())),
+                                juce::dontSendNotification);
+    }
+    
+    const auto& transmitter = audioProcessor.oscTransmitter;
+    if (selectedDestination >= transmitter.getNumDestinations())
+    {
+        oscStatsLabel.setText({}, juce::dontSendNotification);
+        return;
+    }
+    
+    // 顯示目前選擇的目的地的連線狀態與統計
+    const auto& destination = transmitter.getDestination(selectedDestination);
+    const auto health = destination.getHealth();
+    
+    juce::String status = juce::String("Status: ") + OSCDestination::getHealthName(health);
+    if (health == OSCDestination::Health::reconnecting)
+    {
+        const double retryInMs = juce::jmax(0.0, destination.getRetryTimeMs() - juce::Time::getMillisecondCounterHiRes());
+        status << " (retry in " << juce::String(retryInMs / 1000.0, 1) << " s, "
+               << destination.getNumConsecutiveFailures() << " failed sends)";
+    }
+    
+    // 與上一次 timer 之間的速率（切換目的地後的第一次沒有速率）
+    OSCTrafficStats::Snapshot traffic;
+    destination.getTrafficSnapshot(traffic);
+    const auto rates = (previousTrafficDestination == selectedDestination)
+                           ? OSCTrafficStats::computeRates(previousTraffic, traffic)
+                           : OSCTrafficStats::Rates();
+    previousTraffic = traffic;
+    previousTrafficDestination = selectedDestination;
+    
+    status << "\n" << juce::String(rates.messagesPerSecond, 0) << " msg/s  "
+           << juce::String(rates.bytesPerSecond / 1024.0, 1) << " kB/s  "
+           << juce::String(rates.bundlesPerSecond, 0) << " bundles/s  "
+           << "Send p50/p90/p99: " << juce::String(rates.latencyP50Us, 0) << "/"
+           << juce::String(rates.latencyP90Us, 0) << "/" << juce::String(rates.latencyP99Us, 0) << " us";
+    
+    oscStatsLabel.setText(status + "\nQueue: " + juce::String(destination.getQueueDepth()) + "/" + juce::String(OSCDestination::getQueueCapacity())
+                          + "  Sent: " + juce::String(static_cast<juce::int64>(destination.getNumPacketsSent()))
+                          + "  Dropped: " + juce::String(static_cast<juce::int64>(destination.getNumPacketsDropped()))
+                          + "  Errors: " + juce::String(static_cast<juce::int64>(destination.getNumSendErrors()))
+                          + "  Coalesced: " + juce::String(static_cast<juce::int64>(destination.getNumCoalesced()))
+                          + (destination.getNumLatestSlotsExhausted() > 0
+                                 ? "  Slots full: " + juce::String(static_cast<juce::int64>(destination.getNumLatestSlotsExhausted()))
+                                 : juce::String()),
+                          juce::dontSendNotification);
+}
+
+//==============================================================================
+void NetworkSettingsWindow::refreshDestinationList()
+{
+    std::vector<OSCDestination::Settings> destinations;
+    {
+        juce::ScopedLock lock(audioProcessor.oscSettingsLock);
+        destinations = audioProcessor.oscSettings.destinations;
+    }
+    
+    selectedDestination = juce::jlimit(0, juce::jmax(0, static_cast<int>(destinations.size()) - 1), selectedDestination);
+    
+    oscDestinationBox.clear(juce::dontSendNotification);
+    for (size_t i = 0; i < destinations.size(); ++i)
+        oscDestinationBox.addItem(juce::String(static_cast<int>(i) + 1) + ": " + destinations[i].ipAddress + ":" + juce::String(destinations[i].port),
+                                  static_cast<int>(i) + 1);
+    oscDestinationBox.setSelectedItemIndex(selectedDestination, juce::dontSendNotification);
+    
+    oscAddDestinationButton.setEnabled(static_cast<int>(destinations.size()) < OSCTransmitter::maxDestinations);
+    oscRemoveDestinationButton.setEnabled(destinations.size() > 1);
+}
+
+void NetworkSettingsWindow::loadSelectedDestination()
+{
+    OSCDestination::Settings destination;
+    {
+        juce::ScopedLock lock(audioProcessor.oscSettingsLock);
+        const auto& destinations = audioProcessor.oscSettings.destinations;
+        if (selectedDestination < static_cast<int>(destinations.size()))
+            destination = destinations[static_cast<size_t>(selectedDestination)];
+    }
+    
+    oscIpEditor.setText(destination.ipAddress, juce::dontSendNotification);
+    oscPortEditor.setText(juce::String(destination.port), juce::dontSendNotification);
+    oscDestinationEnabledButton.setToggleState(destination.enabled, juce::dontSendNotification);
+    oscBundleButton.setToggleState(destination.bundleMode, juce::dontSendNotification);
+    oscLookaheadButton.setToggleState(destination.lookahead, juce::dontSendNotification);
+    updateLookaheadAvailability(destination);
+    oscHoldButton.setToggleState(destination.holdWhileReconnecting, juce::dontSendNotification);
+    
+    oscMaxRateBox.clear(juce::dontSendNotification);
+    oscMaxRateBox.addItem("Unlimited", 1);
+    for (int rateHz : { 30, 60, 100, 200, 500 })
+        oscMaxRateBox.addItem(juce::String(rateHz) + " Hz", rateHz);
+    
+    const int currentMaxRate = juce::roundToInt(destination.maxRateHz);
+    oscMaxRateBox.setSelectedId(currentMaxRate > 1 ? currentMaxRate : 1, juce::dontSendNotification);
+    if (oscMaxRateBox.getSelectedId() == 0)
+    {
+        // 狀態中保存的頻率不在列表中
+        oscMaxRateBox.addItem(juce::String(currentMaxRate) + " Hz", currentMaxRate);
+        oscMaxRateBox.setSelectedId(currentMaxRate, juce::dontSendNotification);
+    }
+}
+
+void NetworkSettingsWindow::editSelectedDestination(const std::function<void(OSCDestination::Settings&)>& edit)
+{
+    OSCDestination::Settings edited;
+    {
+        juce::ScopedLock lock(audioProcessor.oscSettingsLock);
+        auto& destinations = audioProcessor.oscSettings.destinations;
+        if (selectedDestination >= static_cast<int>(destinations.size()))
+            return;
+        
+        auto& destination = destinations[static_cast<size_t>(selectedDestination)];
+        edit(destination);
+        edited = destination;
+    }
+    audioProcessor.updateOSCConnection();
+    updateLookaheadAvailability(edited);
+    
+    // 更新列表中的地址顯示
+    refreshDestinationList();
+}
+
+void NetworkSettingsWindow::updateLookaheadAvailability(const OSCDestination::Settings& destination)
+{
+    // Lookahead 只在 bundle 模式且不限制頻率時生效（見 OSCDestination::isScheduled()）
+    // 其他情況下停用開關並說明原因，設定值保留，開啟 bundle 模式後恢復
+    const bool available = destination.bundleMode && destination.maxRateHz <= 0.0;
+    oscLookaheadButton.setEnabled(available);
+    oscLookaheadButton.setTooltip(available ? "Send playback positions ahead of time with OSC timetags"
+                                            : "Requires Bundle mode and an unlimited max rate");
+}
+
+//==============================================================================
+void NetworkSettingsWindow::chooseCaptureFile()
+{
+    const auto defaultFile = juce::File::getSpecialLocation(juce::File::userDocumentsDirectory)
+                                 .getChildFile("JYPad Capture" + juce::String(OSCCaptureFile::fileExtension));
+    
+    fileChooser = std::make_unique<juce::FileChooser>("Capture OSC output to...", defaultFile,
+                                                      juce::String("*") + OSCCaptureFile::fileExtension);
+    
+    fileChooser->launchAsync(juce::FileBrowserComponent::saveMode
+                                 | juce::FileBrowserComponent::canSelectFiles
+                                 | juce::FileBrowserComponent::warnAboutOverwriting,
+                             [this](const juce::FileChooser& chooser) {
+        const auto file = chooser.getResult();
+        if (file != juce::File())
+            audioProcessor.oscTransmitter.getCaptureWriter().start(file.withFileExtension(OSCCaptureFile::fileExtension));
+        updateCaptureStatus();
+    });
+}
+
+void NetworkSettingsWindow::chooseReplayFile()
+{
+    fileChooser = std::make_unique<juce::FileChooser>("Replay OSC capture",
+                                                      audioProcessor.oscTransmitter.getCaptureWriter().getFile(),
+                                                      juce::String("*") + OSCCaptureFile::fileExtension);
+    
+    fileChooser->launchAsync(juce::FileBrowserComponent::openMode | juce::FileBrowserComponent::canSelectFiles,
+                             [this](const juce::FileChooser& chooser) {
+        const auto file = chooser.getResult();
+        const int port = replayPortEditor.getText().getIntValue();
+        if (file.existsAsFile() && port > 0 && port < 65536)
+            captureReplayer.start(file, "127.0.0.1", port, selectedDestination, replayFastButton.getToggleState());
+        updateCaptureStatus();
+    });
+}
+
+void NetworkSettingsWindow::updateCaptureStatus()
+{
+    const auto& writer = audioProcessor.oscTransmitter.getCaptureWriter();
+    const auto numCaptured = static_cast<juce::int64>(writer.getNumPacketsWritten());
+    
+    juce::String captureStatus;
+    if (writer.isCapturing())
+        captureStatus << "Capturing: " << numCaptured << " packets, "
+                      << juce::String(static_cast<double>(writer.getNumBytesWritten()) / 1024.0, 1) << " kB";
+    else if (writer.hasFailed())
+        captureStatus << "Write failed after " << numCaptured << " packets";
+    else if (numCaptured > 0)
+        captureStatus << "Saved " << numCaptured << " packets to " << writer.getFile().getFileName();
+    
+    if (writer.getNumPacketsDropped() > 0)
+        captureStatus << "  Dropped: " << static_cast<juce::int64>(writer.getNumPacketsDropped());
+    
+    captureButton.setButtonText(writer.isCapturing() ? "Stop Capture" : "Capture...");
+    captureStatusLabel.setText(captureStatus, juce::dontSendNotification);
+    
+    // 重送的是目前選擇的目的地擷取到的封包
+    const auto numReplayed = static_cast<juce::int64>(captureReplayer.getNumPacketsSent());
+    const auto replayError = captureReplayer.getError();
+    
+    juce::String replayStatus;
+    if (captureReplayer.isReplaying())
+        replayStatus << "Replaying destination " << (selectedDestination + 1) << ": " << numReplayed << " packets, "
+                     << juce::String(captureReplayer.getPositionSeconds(), 1) << " s";
+    else if (replayError.isNotEmpty())
+        replayStatus << "Replay failed: " << replayError;
+    else if (numReplayed > 0)
+        replayStatus << "Replayed " << numReplayed << " packets to 127.0.0.1";
+    else
+        replayStatus << "Replays the selected destination to 127.0.0.1";
+    
+    if (captureReplayer.getNumSendErrors() > 0)
+        replayStatus << "  Errors: " << static_cast<juce::int64>(captureReplayer.getNumSendErrors());
+    
+    replayButton.setButtonText(captureReplayer.isReplaying() ? "Stop Replay" : "Replay...");
+    replayStatusLabel.setText(replayStatus, juce::dontSendNotification);
+}
@@ -2,13 +2,17 @@
 
 #include <juce_gui_basics/juce_gui_basics.h>
 #include "PluginProcessor.h"
+#include "OSCCaptureReplayer.h"
 
 //==============================================================================
 /**
  * Network Settings 視窗
  * 顯示和編輯 OSC 網路設置的獨立視窗
+ * 可以設定多個目的地，每個目的地有自己的地址、啟用狀態、輸出格式與最大頻率
+ * 另外可以把送出的封包擷取到檔案，並把擷取檔重送到本機的接收端
  */
-class NetworkSettingsWindow : public juce::DocumentWindow
+class NetworkSettingsWindow : public juce::DocumentWindow,
+                              private juce::Timer
 {
 public:
     NetworkSettingsWindow(PlugDataCustomObjectAudioProcessor& processor);
@@ -20,15 +24,84 @@ private:
     PlugDataCustomObjectAudioProcessor& audioProcessor;
     
     juce::GroupComponent oscGroup;
+    juce::Label oscDestinationLabel;
+    juce::ComboBox oscDestinationBox;
+    juce::TextButton oscAddDestinationButton;
+    juce::TextButton oscRemoveDestinationButton;
+    juce::ToggleButton oscDestinationEnabledButton;
     juce::Label oscIpLabel;
     juce::TextEditor oscIpEditor;
     juce::Label oscPortLabel;
     juce::TextEditor oscPortEditor;
     juce::ToggleButton oscEnabledButton;
+    juce::ToggleButton oscBundleButton;  // 每個 tick 合併成一個 bundle
     juce::TextButton oscTestButton;
+    juce::Label oscRefreshLabel;
+    juce::ComboBox oscRefreshBox;  // 完整狀態的刷新頻率（所有目的地）
+    juce::Label oscMaxRateLabel;
+    juce::ComboBox oscMaxRateBox;  // 位置的最大發送頻率
+    juce::ToggleButton oscLookaheadButton;  // 回放位置提前發送、以 timetag 排程
+    juce::ToggleButton oscHoldButton;  // 重新連線期間保留佇列中的封包
+    juce::Label oscStatsLabel;  // 連線狀態、流量速率、發送延遲與丟棄計數
+    juce::ToggleButton oscPublishStatsButton;  // 以 /jypad/stats 發布統計
+    
+    // OSC 輸入設置
+    juce::GroupComponent inputGroup;
+    juce::Label inputPortLabel;
+    juce::TextEditor inputPortEditor;
+    juce::ToggleButton inputEnabledButton;
+    juce::Label inputStatsLabel;  // 接收與忽略的數量
+    
+    // 回放設置
+    juce::GroupComponent playbackGroup;
+    juce::Label interpolationLabel;
+    juce::ComboBox interpolationBox;
+    juce::Label outputRateLabel;
+    juce::ComboBox outputRateBox;
+    juce::Label lookaheadLabel;
+    juce::ComboBox lookaheadBox;
+    
+    // 擷取與重送
+    juce::GroupComponent captureGroup;
+    juce::TextButton captureButton;  // 開始 / 停止擷取
+    juce::Label captureStatusLabel;
+    juce::TextButton replayButton;  // 選擇擷取檔並重送 / 停止重送
+    juce::ToggleButton replayFastButton;  // 盡快送出（否則依原本的時間間隔）
+    juce::Label replayPortLabel;
+    juce::TextEditor replayPortEditor;  // 本機接收端的 port
+    juce::Label replayStatusLabel;
+    
+    OSCCaptureReplayer captureReplayer;
+    std::unique_ptr<juce::FileChooser> fileChooser;
+    
+    // 顯示停用控制項的說明（例如 Lookahead 需要 bundle 模式）
+    juce::TooltipWindow tooltipWindow { this };
+    
+    // 目前編輯的目的地（oscSettings.destinations 的索引）
+    int selectedDestination = 0;
+    
+    // 上一次 timer 的流量快照，用來計算速率
+    OSCTrafficStats::Snapshot previousTraffic;
+    int previousTrafficDestination = -1;
     
     void layoutContent(juce::Component* content);
     
+    // 目的地列表與欄位的同步
+    void refreshDestinationList();
+    void loadSelectedDestination();
+    void editSelectedDestination(const std::function<void(OSCDestination::Settings&)>& edit);
+    
+    // Lookahead 開關只在目的地可以提前排程時啟用
+    void updateLookaheadAvailability(const OSCDestination::Settings& destination);
+    
+    // 擷取與重送的檔案選擇
+    void chooseCaptureFile();
+    void chooseReplayFile();
+    void updateCaptureStatus();
+    
+    // 定期更新 OSC 發送統計
+    void timerCallback() override;
+    
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(NetworkSettingsWindow)
 };
 
@@ -0,0 +1,214 @@
+#include "OSCAddressRouter.h"
+#include <algorithm>
+#include <cstring>
+
+//==============================================================================
+OSCAddressRouter::OSCAddressRouter()
+{
+    nodes.emplace_back();  // 根節點
+}
+
+bool OSCAddressRouter::add(const char* address, int target)
+{
+    if (address == nullptr || address[0] != '/')
+        return false;
+
+    int node = 0;
+    const char* segment = address + 1;
+
+    for (;;)
+    {
+        const char* end = segment;
+        while (*end != 0 && *end != '/')
+            ++end;
+
+        const auto length = static_cast<size_t>(end - segment);
+        if (containsWildcard(segment, length))
+            return false;
+
+        node = findOrAddChild(node, segment, length);
+
+        if (*end == 0)
+            break;
+
+        segment = end + 1;
+    }
+
+    auto& targets = nodes[static_cast<size_t>(node)].targets;
+    if (std::find(targets.begin(), targets.end(), target) == targets.end())
+    {
+        targets.push_back(target);
+        ++numRoutes;
+    }
+
+    return true;
+}
+
+//==============================================================================
+juce::uint32 OSCAddressRouter::hashSegment(const char* segment, size_t length) noexcept
+{
+    // FNV-1a
+    juce::uint32 hash = 2166136261u;
+    for (size_t i = 0; i < length; ++i)
+    {
+        hash ^= static_cast<juce::uint8>(segment[i]);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+int OSCAddressRouter::findChild(int node, const char* segment, size_t length) const noexcept
+{
+    const auto& children = nodes[static_cast<size_t>(node)].children;
+    const juce::uint32 hash = hashSegment(segment, length);
+
+    auto it = std::lower_bound(children.begin(), children.end(), hash,
+                               [](const Child& child, juce::uint32 h) { return child.hash < h; });
+
+    // 雜湊相同的子節點再比對字串
+    for (; it != children.end() && it->hash == hash; ++it)
+    {
+        const auto& name = nodes[static_cast<size_t>(it->node)].segment;
+        if (name.size() == length && std::memcmp(name.data(), segment, length) == 0)
+            return it->node;
+    }
+
+    return -1;
+}
+
+int OSCAddressRouter::findOrAddChild(int node, const char* segment, size_t length)
+{
+    const int existing = findChild(node, segment, length);
+    if (existing >= 0)
+        return existing;
+
+    const int child = static_cast<int>(nodes.size());
+    nodes.emplace_back();
+    nodes.back().segment.assign(segment, length);
+
+    // 注意：emplace_back 之後才取得 children 的參考（vector 可能已重新配置）
+    auto& children = nodes[static_cast<size_t>(node)].children;
+    const juce::uint32 hash = hashSegment(segment, length);
+    auto it = std::upper_bound(children.begin(), children.end(), hash,
+                               [](juce::uint32 h, const Child& c) { return h < c.hash; });
+    children.insert(it, Child { hash, child });
+
+    return child;
+}
+
+//==============================================================================
+bool OSCAddressRouter::containsWildcard(const char* segment, size_t length) noexcept
+{
+    for (size_t i = 0; i < length; ++i)
+    {
+        switch (segment[i])
+        {
+            case '*': case '?': case '[': case ']': case '{': case '}':
+                return true;
+            default:
+                break;
+        }
+    }
+    return false;
+}
+
+bool OSCAddressRouter::segmentMatches(const char* pattern, size_t patternLength, const char* name, size_t nameLength) noexcept
+{
+    size_t p = 0, n = 0;
+
+    while (p < patternLength)
+    {
+        const char c = pattern[p];
+
+        if (c == '*')
+        {
+            // 連續的 * 等同一個
+            while (p < patternLength && pattern[p] == '*')
+                ++p;
+
+            if (p == patternLength)
+                return true;
+
+            for (size_t k = n; k <= nameLength; ++k)
+                if (segmentMatches(pattern + p, patternLength - p, name + k, nameLength - k))
+                    return true;
+
+            return false;
+        }
+
+        if (c == '{')
+        {
+            const auto* close = static_cast<const char*>(std::memchr(pattern + p, '}', patternLength - p));
+            if (close == nullptr)
+                return false;
+
+            const size_t afterClose = static_cast<size_t>(close - pattern) + 1;
+            const char* alternative = pattern + p + 1;
+
+            // 逐一嘗試以逗號分隔的字串
+            while (alternative <= close)
+            {
+                const char* altEnd = alternative;
+                while (altEnd < close && *altEnd != ',')
+                    ++altEnd;
+
+                const auto altLength = static_cast<size_t>(altEnd - alternative);
+                if (altLength <= nameLength - n && std::memcmp(alternative, name + n, altLength) == 0
+                    && segmentMatches(pattern + afterClose, patternLength - afterClose,
+                                      name + n + altLength, nameLength - n - altLength))
+                    return true;
+
+                alternative = altEnd + 1;
+            }
+
+            return false;
+        }
+
+        if (n >= nameLength)
+            return false;
+
+        if (c == '[')
+        {
+            const auto* close = static_cast<const char*>(std::memchr(pattern + p + 1, ']', patternLength - p - 1));
+            if (close == nullptr)
+                return false;
+
+            const char* set = pattern + p + 1;
+            const bool negate = (set < close && *set == '!');
+            if (negate)
+                ++set;
+
+            const char ch = name[n];
+            bool inSet = false;
+
+            for (; set < close; ++set)
+            {
+                if (set + 2 < close && set[1] == '-')
+                {
+                    if (ch >= set[0] && ch <= set[2])
+                        inSet = true;
+                    set += 2;
+                }
+                else if (*set == ch)
+                {
+                    inSet = true;
+                }
+            }
+
+            if (inSet == negate)
+                return false;
+
+            p = static_cast<size_t>(close - pattern) + 1;
+            ++n;
+            continue;
+        }
+
+        if (c != '?' && c != name[n])
+            return false;
+
+        ++p;
+        ++n;
+    }
+
+    return n == nameLength;
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <string>
+#include <vector>
+
+//==============================================================================
+/**
+ * 預先編譯的 OSC 地址路由表（依路徑分段建立的 trie）
+ * 每個註冊的地址（例如 "/track/1/xy"）以 '/' 切成分段存入樹中，葉節點記錄目標 ID（球的 ID）。
+ * 查詢時逐段往下走：一般分段用雜湊查找子節點，所以每個封包的成本只和地址的深度有關，
+ * 與註冊的地址數量無關；含有 OSC 萬用字元（* ? [] {}）的分段才會逐一比對該層的子節點。
+ *
+ * 路由表建好後是唯讀的：來源改變時在其他線程重建一份新的，再整份替換。
+ *
+ * 用法：
+ *   OSCAddressRouter router;
+ *   router.add ("/track/1/xy", 1);
+ *   router.match ("/track/{1,2}/xy", [] (int target) { ... });
+ */
+class OSCAddressRouter
+{
+public:
+    OSCAddressRouter();
+
+    // 註冊地址與目標（同一個地址可以有多個目標）；地址不以 '/' 開頭或含有萬用字元時返回 false
+    bool add(const char* address, int target);
+
+    int getNumRoutes() const noexcept { return numRoutes; }
+
+    // 對每個符合 pattern 的目標呼叫 callback(int target)，返回符合的數量（不配置記憶體）
+    template <typename Callback>
+    int match(const char* pattern, Callback&& callback) const
+    {
+        if (pattern == nullptr || pattern[0] != '/')
+            return 0;
+
+        return matchFrom(0, pattern + 1, callback);
+    }
+
+    // OSC 1.0 的分段比對：* ? [abc] [a-z] [!abc] {foo,bar}
+    static bool segmentMatches(const char* pattern, size_t patternLength, const char* name, size_t nameLength) noexcept;
+
+    static bool containsWildcard(const char* segment, size_t length) noexcept;
+
+private:
+    struct Child
+    {
+        juce::uint32 hash;
+        int node;
+    };
+
+    struct Node
+    {
+        std::string segment;
+        std::vector<Child> children;   // 依 hash 排序
+        std::vector<int> targets;
+    };
+
+    std::vector<Node> nodes;
+    int numRoutes = 0;
+
+    static juce::uint32 hashSegment(const char* segment, size_t length) noexcept;
+
+    int findChild(int node, const char* segment, size_t length) const noexcept;
+    int findOrAddChild(int node, const char* segment, size_t length);
+
+    // 從 node 開始比對剩下的地址（rest 不含開頭的 '/'）
+    template <typename Callback>
+    int matchFrom(int node, const char* rest, Callback& callback) const
+    {
+        const char* end = rest;
+        while (*end != 0 && *end != '/')
+            ++end;
+
+        const auto length = static_cast<size_t>(end - rest);
+        const bool isLast = (*end == 0);
+        int numMatched = 0;
+
+        const auto visit = [&](int child)
+        {
+            if (isLast)
+            {
+                for (int target : nodes[static_cast<size_t>(child)].targets)
+                {
+                    callback(target);
+                    ++numMatched;
+                }
+            }
+            else
+            {
+                numMatched += matchFrom(child, end + 1, callback);
+            }
+        };
+
+        if (!containsWildcard(rest, length))
+        {
+            const int child = findChild(node, rest, length);
+            if (child >= 0)
+                visit(child);
+            return numMatched;
+        }
+
+        for (const auto& child : nodes[static_cast<size_t>(node)].children)
+        {
+            const auto& segment = nodes[static_cast<size_t>(child.node)].segment;
+            if (segmentMatches(rest, length, segment.data(), segment.size()))
+                visit(child.node);
+        }
+
+        return numMatched;
+    }
+
+    JUCE_LEAK_DETECTOR(OSCAddressRouter)
+};
@@ -0,0 +1,68 @@
+#include "OSCBundleBuilder.h"
+
+//==============================================================================
+OSCBundleBuilder::OSCBundleBuilder(OSCDestination& oscDestination) noexcept
+    : destination(oscDestination)
+{
+}
+
+OSCBundleBuilder::~OSCBundleBuilder()
+{
+    jassert(!open);  // 每個 begin() 都要有對應的 end()
+}
+
+//==============================================================================
+void OSCBundleBuilder::begin(juce::uint64 timeTag) noexcept
+{
+    jassert(!open);
+
+    currentTimeTag = timeTag;
+    numMessages = 0;
+    numPendingMessages = 0;
+    open = true;
+
+    writer.reset();
+    writer.beginBundle(currentTimeTag);
+}
+
+void OSCBundleBuilder::end() noexcept
+{
+    if (!open)
+        return;
+
+    flush();
+    open = false;
+}
+
+bool OSCBundleBuilder::addMessage(const char* messageData, int messageSize) noexcept
+{
+    jassert(open);
+
+    constexpr int maxElementSize = OSCDestination::maxPacketSize
+                                 - OSCPacketWriter::bundleHeaderSize
+                                 - OSCPacketWriter::bundleElementOverhead;
+
+    if (!open || messageSize <= 0 || messageSize > maxElementSize)
+        return false;
+
+    // 放不下時先送出目前的 bundle（只在超過 MTU 時拆開）
+    if (writer.getSize() + OSCPacketWriter::bundleElementOverhead + messageSize > writer.getCapacity())
+        flush();
+
+    writer.writeBundleElement(messageData, messageSize);
+    ++numPendingMessages;
+    ++numMessages;
+    return true;
+}
+
+//==============================================================================
+void OSCBundleBuilder::flush() noexcept
+{
+    // 空的 bundle 不送出
+    if (numPendingMessages > 0 && writer.isValid())
+        destination.enqueue(buffer, writer.getSize());
+
+    numPendingMessages = 0;
+    writer.reset();
+    writer.beginBundle(currentTimeTag);
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include "OSCPacketWriter.h"
+#include "OSCDestination.h"
+
+//==============================================================================
+/**
+ * 把同一個更新週期（tick）的多個 OSC 訊息合併成一個帶 timetag 的 bundle
+ * begin() 開始一個 frame，addMessage() 加入已編碼的訊息，end() 把剩下的內容放入目的地的發送佇列。
+ * bundle 只有在超過單一 UDP 封包大小（OSCDestination::maxPacketSize）時才會拆開，
+ * 拆開後的每個 bundle 使用相同的 timetag。
+ *
+ * 不配置記憶體、不上鎖；同一個實例只能由一個線程使用。
+ */
+class OSCBundleBuilder
+{
+public:
+    explicit OSCBundleBuilder(OSCDestination& destination) noexcept;
+    ~OSCBundleBuilder();
+
+    // OSC 規範中代表「立即」的 timetag
+    static constexpr juce::uint64 immediateTimeTag = 1;
+
+    void begin(juce::uint64 timeTag) noexcept;
+    void end() noexcept;
+    bool isOpen() const noexcept { return open; }
+
+    // 加入一個完整的 OSC 訊息；訊息本身放不進一個封包時返回 false
+    bool addMessage(const char* messageData, int messageSize) noexcept;
+
+    int getNumMessages() const noexcept { return numMessages; }
+
+private:
+    OSCDestination& destination;
+
+    char buffer[OSCDestination::maxPacketSize];
+    OSCPacketWriter writer { buffer, OSCDestination::maxPacketSize };
+
+    juce::uint64 currentTimeTag = immediateTimeTag;
+    int numMessages = 0;          // 整個 frame 的訊息數
+    int numPendingMessages = 0;   // 目前緩衝區中的訊息數
+    bool open = false;
+
+    // 把目前的 bundle 放入佇列，並以相同的 timetag 開始下一個
+    void flush() noexcept;
+
+    JUCE_DECLARE_NON_COPYABLE(OSCBundleBuilder)
+};
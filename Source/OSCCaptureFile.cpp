@@ -0,0 +1,75 @@
+#include "OSCCaptureFile.h"
+#include <cstring>
+
+//==============================================================================
+void OSCCaptureFile::writeHeader(juce::OutputStream& stream, juce::int64 startTimeMs)
+{
+    stream.write(magic, sizeof(magic));
+    stream.writeInt(version);
+    stream.writeInt64(startTimeMs);
+}
+
+bool OSCCaptureFile::writeRecord(juce::OutputStream& stream, juce::int64 timeUs, int destinationIndex,
+                                 const char* packetData, int packetSize)
+{
+    if (packetSize <= 0 || packetSize > maxPacketSize)
+        return false;
+
+    return stream.writeInt64(timeUs)
+        && stream.writeByte(static_cast<char>(destinationIndex))
+        && stream.writeShort(static_cast<short>(static_cast<juce::uint16>(packetSize)))
+        && stream.write(packetData, static_cast<size_t>(packetSize));
+}
+
+//==============================================================================
+OSCCaptureFile::Reader::Reader(const juce::File& file)
+    : stream(file.createInputStream())
+{
+    if (stream == nullptr)
+    {
+        error = "Cannot open " + file.getFullPathName();
+        return;
+    }
+
+    char fileMagic[sizeof(magic)];
+    if (stream->read(fileMagic, sizeof(fileMagic)) != static_cast<int>(sizeof(fileMagic))
+        || std::memcmp(fileMagic, magic, sizeof(magic)) != 0)
+    {
+        error = "Not an OSC capture file";
+        return;
+    }
+
+    const int fileVersion = stream->readInt();
+    if (fileVersion != version)
+    {
+        error = "Unsupported capture version " + juce::String(fileVersion);
+        return;
+    }
+
+    startTimeMs = stream->readInt64();
+}
+
+bool OSCCaptureFile::Reader::readNext(Record& record)
+{
+    if (!isValid() || stream->isExhausted())
+        return false;
+
+    if (stream->getNumBytesRemaining() < recordHeaderSize)
+    {
+        error = "Truncated record";
+        return false;
+    }
+
+    record.timeUs = stream->readInt64();
+    record.destinationIndex = static_cast<juce::uint8>(stream->readByte());
+    const int packetSize = static_cast<juce::uint16>(stream->readShort());
+
+    record.data.resize(static_cast<size_t>(packetSize));
+    if (packetSize == 0 || stream->read(record.data.data(), packetSize) != packetSize)
+    {
+        error = "Truncated record";
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <memory>
+#include <vector>
+
+//==============================================================================
+/**
+ * OSC 輸出擷取檔（.jyosc）的格式
+ * 記錄每一個送出的 UDP 封包與高精度時間戳，用來除錯演出或做回歸測試。
+ *
+ * 所有整數都是 little-endian：
+ *   檔頭：  magic "JYOSCCAP"（8 bytes）、版本 (int32)、開始擷取的時間 (int64，Unix 毫秒)
+ *   每筆：  距開始的時間 (int64，微秒)、目的地索引 (uint8)、封包大小 (uint16)、封包內容
+ * 每筆只多 11 bytes，封包內容原樣保存（訊息或 bundle）。
+ */
+class OSCCaptureFile
+{
+public:
+    static constexpr const char* fileExtension = ".jyosc";
+    static constexpr int version = 1;
+    static constexpr int headerSize = 20;
+    static constexpr int recordHeaderSize = 11;
+
+    // 封包大小以 uint16 保存
+    static constexpr int maxPacketSize = 65535;
+
+    static void writeHeader(juce::OutputStream& stream, juce::int64 startTimeMs);
+
+    // 寫入一筆記錄；返回是否全部寫入
+    static bool writeRecord(juce::OutputStream& stream, juce::int64 timeUs, int destinationIndex,
+                            const char* packetData, int packetSize);
+
+    struct Record
+    {
+        juce::int64 timeUs = 0;
+        int destinationIndex = 0;
+        std::vector<char> data;  // 重複使用，讀取時不會每筆都配置記憶體
+    };
+
+    //==============================================================================
+    // 依序讀取擷取檔（不在即時線程中使用）
+    class Reader
+    {
+    public:
+        explicit Reader(const juce::File& file);
+
+        // 檔頭是否有效；無效時 getError() 說明原因
+        bool isValid() const noexcept { return error.isEmpty(); }
+        const juce::String& getError() const noexcept { return error; }
+
+        juce::int64 getStartTimeMs() const noexcept { return startTimeMs; }
+
+        // 讀取下一筆；到檔尾或記錄不完整時返回 false（不完整時設定 getError()）
+        bool readNext(Record& record);
+
+    private:
+        std::unique_ptr<juce::FileInputStream> stream;
+        juce::int64 startTimeMs = 0;
+        juce::String error;
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Reader)
+    };
+
+private:
+    static constexpr char magic[8] = { 'J', 'Y', 'O', 'S', 'C', 'C', 'A', 'P' };
+};
@@ -0,0 +1,125 @@
+#include "OSCCaptureReplayer.h"
+#include "DebugLogger.h"
+
+//==============================================================================
+OSCCaptureReplayer::OSCCaptureReplayer()
+    : juce::Thread("JYPad OSC Replay")
+{
+}
+
+OSCCaptureReplayer::~OSCCaptureReplayer()
+{
+    stop();
+}
+
+//==============================================================================
+bool OSCCaptureReplayer::start(const juce::File& file, const juce::String& hostName, int portNumber,
+                               int destinationIndex, bool asFastAsPossible)
+{
+    stop();
+
+    auto newReader = std::make_unique<OSCCaptureFile::Reader>(file);
+    if (!newReader->isValid())
+    {
+        setError(newReader->getError());
+        DEBUG_LOG_ERROR("OSCCaptureReplayer: " + newReader->getError());
+        return false;
+    }
+
+    reader = std::move(newReader);
+    host = hostName;
+    port = portNumber;
+    destinationFilter = destinationIndex;
+    fast = asFastAsPossible;
+
+    setError({});
+    numPacketsSent = 0;
+    numSendErrors = 0;
+    positionSeconds = 0.0;
+
+    startThread(juce::Thread::Priority::high);
+
+    DEBUG_LOG("OSCCaptureReplayer: Replaying " + file.getFullPathName() + " to " + host + ":" + juce::String(port)
+              + (fast ? " (as fast as possible)" : " (original timing)"));
+    return true;
+}
+
+void OSCCaptureReplayer::stop()
+{
+    stopThread(1000);
+    reader.reset();
+}
+
+juce::String OSCCaptureReplayer::getError() const
+{
+    const juce::ScopedLock lock(errorLock);
+    return error;
+}
+
+void OSCCaptureReplayer::setError(const juce::String& message)
+{
+    const juce::ScopedLock lock(errorLock);
+    error = message;
+}
+
+//==============================================================================
+void OSCCaptureReplayer::waitUntil(juce::int64 targetTicks)
+{
+    for (;;)
+    {
+        const double remainingMs = juce::Time::highResolutionTicksToSeconds(targetTicks - juce::Time::getHighResolutionTicks()) * 1000.0;
+        if (remainingMs <= 0.0 || threadShouldExit())
+            return;
+
+        // 睡眠的精度只有毫秒級：剩下的一小段時間改為讓出 CPU
+        if (remainingMs > sleepThresholdMs)
+            wait(static_cast<int>(remainingMs - sleepThresholdMs) + 1);
+        else
+            juce::Thread::yield();
+    }
+}
+
+void OSCCaptureReplayer::run()
+{
+    juce::DatagramSocket socket(false);
+    if (!socket.bindToPort(0))
+    {
+        setError("Cannot open socket");
+        return;
+    }
+
+    OSCCaptureFile::Record record;
+    const auto startTicks = juce::Time::getHighResolutionTicks();
+    juce::int64 firstTimeUs = -1;
+
+    while (!threadShouldExit() && reader->readNext(record))
+    {
+        if (destinationFilter >= 0 && record.destinationIndex != destinationFilter)
+            continue;
+
+        // 以第一個重送的封包為時間零點
+        if (firstTimeUs < 0)
+            firstTimeUs = record.timeUs;
+
+        const double offsetSeconds = static_cast<double>(record.timeUs - firstTimeUs) * 1.0e-6;
+
+        if (!fast)
+            waitUntil(startTicks + juce::Time::secondsToHighResolutionTicks(offsetSeconds));
+
+        if (threadShouldExit())
+            break;
+
+        const int size = static_cast<int>(record.data.size());
+        if (socket.write(host, port, record.data.data(), size) == size)
+            ++numPacketsSent;
+        else
+            ++numSendErrors;
+
+        positionSeconds = offsetSeconds;
+    }
+
+    if (!reader->isValid())
+        setError(reader->getError());
+
+    DEBUG_LOG("OSCCaptureReplayer: Finished, " + juce::String(static_cast<juce::int64>(getNumPacketsSent())) + " packets sent");
+}
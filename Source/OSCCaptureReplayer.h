@@ -0,0 +1,64 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <atomic>
+#include <memory>
+#include "OSCCaptureFile.h"
+
+//==============================================================================
+/**
+ * 重送 OSC 擷取檔
+ * 在自己的線程中把擷取檔的封包原樣送到指定的接收端（通常是本機），
+ * 依原本的時間間隔送出（重現演出時的時序），或盡快送出（回歸測試）。
+ */
+class OSCCaptureReplayer : private juce::Thread
+{
+public:
+    OSCCaptureReplayer();
+    ~OSCCaptureReplayer() override;
+
+    // 開始重送（訊息線程）；destinationIndex < 0 時重送所有目的地的封包
+    // 檔案無效時返回 false，原因見 getError()
+    bool start(const juce::File& file, const juce::String& host, int port,
+               int destinationIndex, bool asFastAsPossible);
+
+    // 停止重送（訊息線程）
+    void stop();
+
+    bool isReplaying() const noexcept { return isThreadRunning(); }
+
+    // 上一次開始或重送時的錯誤（訊息線程，重送結束後讀取）
+    juce::String getError() const;
+
+    // 統計（供 UI 顯示，每次開始時歸零）
+    juce::uint64 getNumPacketsSent() const noexcept { return numPacketsSent.load(); }
+    juce::uint64 getNumSendErrors() const noexcept { return numSendErrors.load(); }
+
+    // 已重送到擷取檔中的哪個時間（秒）
+    double getPositionSeconds() const noexcept { return positionSeconds.load(std::memory_order_relaxed); }
+
+private:
+    // 以下在 start() 中設定，重送期間只由重送線程使用
+    std::unique_ptr<OSCCaptureFile::Reader> reader;
+    juce::String host;
+    int port = 0;
+    int destinationFilter = -1;
+    bool fast = false;
+
+    juce::String error;
+    mutable juce::CriticalSection errorLock;
+
+    std::atomic<juce::uint64> numPacketsSent { 0 };
+    std::atomic<juce::uint64> numSendErrors { 0 };
+    std::atomic<double> positionSeconds { 0.0 };
+
+    // 等待到目標時間：剩下超過這個時間時睡眠，之後讓出 CPU 直到時間到達
+    static constexpr double sleepThresholdMs = 2.0;
+
+    void setError(const juce::String& message);
+    void waitUntil(juce::int64 targetTicks);
+
+    void run() override;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(OSCCaptureReplayer)
+};
@@ -0,0 +1,130 @@
+#include "OSCCaptureWriter.h"
+#include "OSCCaptureFile.h"
+#include "DebugLogger.h"
+#include <cstring>
+
+//==============================================================================
+OSCCaptureWriter::OSCCaptureWriter()
+    : juce::Thread("JYPad OSC Capture")
+{
+}
+
+OSCCaptureWriter::~OSCCaptureWriter()
+{
+    stop();
+}
+
+//==============================================================================
+bool OSCCaptureWriter::start(const juce::File& captureFile)
+{
+    stop();
+
+    // 上一次停止後才送出的封包不屬於這次擷取
+    while (queue.tryPop([](const Packet&) {}))
+        ;
+
+    file = captureFile;
+
+    auto newStream = std::make_unique<juce::FileOutputStream>(file);
+    if (newStream->failedToOpen() || !newStream->setPosition(0) || newStream->truncate().failed())
+    {
+        DEBUG_LOG_ERROR("OSCCaptureWriter: Cannot open " + file.getFullPathName());
+        return false;
+    }
+
+    OSCCaptureFile::writeHeader(*newStream, juce::Time::currentTimeMillis());
+
+    stream = std::move(newStream);
+    startTicks = juce::Time::getHighResolutionTicks();
+    numPacketsWritten = 0;
+    numPacketsDropped = 0;
+    numBytesWritten = OSCCaptureFile::headerSize;
+    failed = false;
+    capturing = true;
+
+    startThread(juce::Thread::Priority::low);
+
+    DEBUG_LOG("OSCCaptureWriter: Capturing to " + file.getFullPathName());
+    return true;
+}
+
+void OSCCaptureWriter::stop()
+{
+    capturing = false;
+
+    if (stream == nullptr)
+        return;
+
+    // 寫檔線程結束前會寫完佇列
+    signalThreadShouldExit();
+    notify();
+    stopThread(2000);
+
+    stream->flush();
+    stream.reset();
+
+    DEBUG_LOG("OSCCaptureWriter: Stopped, " + juce::String(static_cast<juce::int64>(getNumPacketsWritten())) + " packets, "
+              + juce::String(static_cast<juce::int64>(getNumPacketsDropped())) + " dropped");
+}
+
+//==============================================================================
+void OSCCaptureWriter::record(int destinationIndex, const char* packetData, int packetSize) noexcept
+{
+    if (!isCapturing())
+        return;
+
+    const auto ticks = juce::Time::getHighResolutionTicks();
+
+    const bool pushed = queue.tryPush([=](Packet& packet)
+    {
+        packet.ticks = ticks;
+        packet.destinationIndex = destinationIndex;
+        packet.size = packetSize;
+        std::memcpy(packet.data, packetData, static_cast<size_t>(packetSize));
+    });
+
+    if (!pushed)
+        ++numPacketsDropped;
+}
+
+int OSCCaptureWriter::writePending()
+{
+    int numWritten = 0;
+
+    while (queue.tryPop([this](const Packet& packet)
+           {
+               if (failed.load(std::memory_order_relaxed))
+                   return;
+
+               const double seconds = juce::Time::highResolutionTicksToSeconds(juce::jmax<juce::int64>(0, packet.ticks - startTicks));
+               const auto timeUs = static_cast<juce::int64>(seconds * 1.0e6);
+
+               if (!OSCCaptureFile::writeRecord(*stream, timeUs, packet.destinationIndex, packet.data, packet.size))
+               {
+                   // 之後的封包都無法寫入：停止擷取，已寫入的部分仍然可以重送
+                   failed = true;
+                   capturing = false;
+                   DEBUG_LOG_ERROR("OSCCaptureWriter: Write failed, capture stopped");
+                   return;
+               }
+
+               ++numPacketsWritten;
+               numBytesWritten += static_cast<juce::uint64>(OSCCaptureFile::recordHeaderSize + packet.size);
+           }))
+    {
+        ++numWritten;
+    }
+
+    return numWritten;
+}
+
+void OSCCaptureWriter::run()
+{
+    while (!threadShouldExit())
+    {
+        if (writePending() == 0)
+            wait(idleWaitMs);
+    }
+
+    writePending();
+}
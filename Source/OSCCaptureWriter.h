@@ -0,0 +1,77 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <atomic>
+#include <memory>
+#include "BoundedMPSCQueue.h"
+#include "OSCDestination.h"
+
+//==============================================================================
+/**
+ * OSC 輸出擷取
+ * 發送線程每寫出一個封包就呼叫 record()，把封包與高精度時間戳放入無鎖佇列；
+ * 背景的寫檔線程把佇列寫入擷取檔（OSCCaptureFile 格式），
+ * 所以擷取不會讓發送線程等待磁碟。佇列滿時丟棄並計數（不影響實際發送）。
+ */
+class OSCCaptureWriter : private juce::Thread
+{
+public:
+    OSCCaptureWriter();
+    ~OSCCaptureWriter() override;
+
+    // 開始擷取到 file（訊息線程）；覆寫已存在的檔案，無法開啟時返回 false
+    bool start(const juce::File& file);
+
+    // 停止擷取（訊息線程）：寫完佇列中剩下的封包後關閉檔案
+    void stop();
+
+    bool isCapturing() const noexcept { return capturing.load(std::memory_order_relaxed); }
+
+    // 寫入失敗（例如磁碟已滿）時擷取自動停止
+    bool hasFailed() const noexcept { return failed.load(std::memory_order_relaxed); }
+
+    // 目前（或上一次）的擷取檔（訊息線程）
+    const juce::File& getFile() const noexcept { return file; }
+
+    // 記錄一個已送出的封包（發送線程，不上鎖、不配置記憶體）
+    void record(int destinationIndex, const char* packetData, int packetSize) noexcept;
+
+    // 統計（供 UI 顯示，每次開始時歸零）
+    juce::uint64 getNumPacketsWritten() const noexcept { return numPacketsWritten.load(); }
+    juce::uint64 getNumPacketsDropped() const noexcept { return numPacketsDropped.load(); }
+    juce::uint64 getNumBytesWritten() const noexcept { return numBytesWritten.load(); }
+
+private:
+    struct Packet
+    {
+        juce::int64 ticks = 0;  // juce::Time::getHighResolutionTicks()
+        int destinationIndex = 0;
+        int size = 0;
+        char data[OSCDestination::maxPacketSize];
+    };
+
+    static constexpr size_t queueCapacity = 512;
+
+    BoundedMPSCQueue<Packet, queueCapacity> queue;
+
+    // 只在寫檔線程中使用（start() 之後、stop() 之前）
+    std::unique_ptr<juce::FileOutputStream> stream;
+    juce::int64 startTicks = 0;
+
+    juce::File file;
+    std::atomic<bool> capturing { false };
+    std::atomic<bool> failed { false };
+    std::atomic<juce::uint64> numPacketsWritten { 0 };
+    std::atomic<juce::uint64> numPacketsDropped { 0 };
+    std::atomic<juce::uint64> numBytesWritten { 0 };
+
+    // 佇列空的時候寫檔線程的等待時間
+    static constexpr int idleWaitMs = 5;
+
+    // 把佇列中的封包寫入檔案，返回寫入的數量
+    int writePending();
+
+    void run() override;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(OSCCaptureWriter)
+};
@@ -0,0 +1,234 @@
+#include "OSCDestination.h"
+#include "OSCBundleBuilder.h"
+#include "OSCCaptureWriter.h"
+#include "DebugLogger.h"
+#include <cstring>
+
+//==============================================================================
+OSCDestination::OSCDestination()
+{
+}
+
+OSCDestination::~OSCDestination()
+{
+}
+
+//==============================================================================
+void OSCDestination::applySettings(const Settings& settings, bool shouldBeEnabled)
+{
+    {
+        // 只有地址改變時才重新開啟 socket；其他設定的改變保留連線狀態與退避
+        const juce::ScopedLock lock(addressLock);
+        if (pendingHost != settings.ipAddress || pendingPort != settings.port)
+        {
+            pendingHost = settings.ipAddress;
+            pendingPort = settings.port;
+            addressChanged = true;
+        }
+    }
+    bundleMode = settings.bundleMode;
+    maxRateHz = juce::jlimit(0.0, maxAllowedRateHz, settings.maxRateHz);
+    lookahead = settings.lookahead;
+    holdWhileReconnecting = settings.holdWhileReconnecting;
+    enabled = shouldBeEnabled;
+}
+
+const char* OSCDestination::getHealthName(Health healthState) noexcept
+{
+    switch (healthState)
+    {
+        case Health::disabled:      return "Disabled";
+        case Health::connecting:    return "Connecting";
+        case Health::connected:     return "Connected";
+        case Health::reconnecting:  return "Reconnecting";
+    }
+
+    return "";
+}
+
+bool OSCDestination::enqueue(const char* packetData, int packetSize) noexcept
+{
+    if (!isEnabled())
+        return false;
+
+    if (packetSize <= 0 || packetSize > maxPacketSize)
+    {
+        ++numPacketsDropped;
+        return false;
+    }
+
+    const bool pushed = queue.tryPush([packetData, packetSize](Packet& packet)
+    {
+        packet.size = packetSize;
+        std::memcpy(packet.data, packetData, static_cast<size_t>(packetSize));
+    });
+
+    if (!pushed)
+        ++numPacketsDropped;
+
+    return pushed;
+}
+
+bool OSCDestination::storeLatest(int key, const char* messageData, int messageSize) noexcept
+{
+    return isEnabled() && isCoalescing() && latestValues.store(key, messageData, messageSize);
+}
+
+//==============================================================================
+int OSCDestination::drainLatestValues()
+{
+    if (!isBundleMode())
+        return latestValues.drain([this](const char* messageData, int messageSize)
+        {
+            enqueue(messageData, messageSize);
+        });
+
+    // 同一個週期的所有最新值合併成一個 bundle（超過封包大小時才拆開）
+    OSCBundleBuilder bundle(*this);
+    bundle.begin(OSCPacketWriter::timeTagFromNow(0.0));
+    const int numDrained = latestValues.drain([&bundle](const char* messageData, int messageSize)
+    {
+        bundle.addMessage(messageData, messageSize);
+    });
+    bundle.end();
+    return numDrained;
+}
+
+bool OSCDestination::updateConnection(double nowMs)
+{
+    if (addressChanged.exchange(false))
+    {
+        {
+            const juce::ScopedLock lock(addressLock);
+            host = pendingHost;
+            port = pendingPort;
+        }
+
+        // 新的地址：立即重新開啟，重設退避
+        socket.reset();
+        backoffMs = 0.0;
+        retryTimeMs = 0.0;
+        numConsecutiveFailures = 0;
+        health = Health::connecting;
+    }
+
+    if (!isEnabled())
+    {
+        // 停用時清除退避，重新啟用後立即開啟
+        socket.reset();
+        backoffMs = 0.0;
+        retryTimeMs = 0.0;
+        numConsecutiveFailures = 0;
+        health = Health::disabled;
+        return false;
+    }
+
+    if (socket != nullptr)
+        return true;
+
+    if (getHealth() == Health::disabled)
+        health = Health::connecting;
+
+    if (nowMs < getRetryTimeMs())
+        return false;
+
+    // 開啟 socket（綁定到任意的本地 port）；地址無效時同樣進入退避
+    auto newSocket = std::make_unique<juce::DatagramSocket>(false);
+    if (host.isEmpty() || port <= 0 || port >= 65536 || !newSocket->bindToPort(0))
+    {
+        scheduleReconnect(nowMs);
+        return false;
+    }
+
+    socket = std::move(newSocket);
+    health = Health::connected;
+    return true;
+}
+
+void OSCDestination::scheduleReconnect(double nowMs)
+{
+    socket.reset();
+    backoffMs = juce::jlimit(initialBackoffMs, maxBackoffMs, backoffMs * 2.0);
+    retryTimeMs = nowMs + backoffMs;
+    health = Health::reconnecting;
+
+    DEBUG_LOG_ERROR("OSCDestination: " + host + ":" + juce::String(port) + " unavailable, retrying in "
+                    + juce::String(backoffMs, 0) + " ms");
+}
+
+void OSCDestination::getTrafficSnapshot(OSCTrafficStats::Snapshot& snapshot) const noexcept
+{
+    trafficStats.fillSnapshot(snapshot);
+    snapshot.packetsDropped = getNumPacketsDropped();
+    snapshot.queueDepth = getQueueDepth();
+}
+
+int OSCDestination::discardQueue() noexcept
+{
+    int numDiscarded = 0;
+    while (queue.tryPop([](const Packet&) {}))
+        ++numDiscarded;
+
+    numPacketsDropped += static_cast<juce::uint64>(numDiscarded);
+    return numDiscarded;
+}
+
+int OSCDestination::service(int maxPackets)
+{
+    const double nowMs = juce::Time::getMillisecondCounterHiRes();
+
+    if (!updateConnection(nowMs))
+    {
+        // 停用時丟棄；重新連線期間依設定丟棄或保留（保留時佇列滿了新的封包才被丟棄）
+        // 限制頻率的最新值不受影響，恢復後送出每個球的最新位置
+        if (!isEnabled() || !holdWhileReconnecting.load(std::memory_order_relaxed))
+            return discardQueue();
+
+        return 0;
+    }
+
+    // 依最大頻率送出最新值；閒置後的第一次更新立即送出
+    const double rateHz = getMaxRateHz();
+    if (rateHz > 0.0)
+    {
+        if (nowMs >= nextDrainTimeMs && drainLatestValues() > 0)
+            nextDrainTimeMs = nowMs + 1000.0 / rateHz;
+    }
+
+    int numServiced = 0;
+
+    while (numServiced < maxPackets
+           && socket != nullptr
+           && queue.tryPop([this, nowMs](const Packet& packet)
+              {
+                  const auto startTicks = juce::Time::getHighResolutionTicks();
+                  const bool written = (socket->write(host, port, packet.data, packet.size) == packet.size);
+                  const double latencyUs = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks) * 1.0e6;
+
+                  if (written)
+                  {
+                      bool isBundle = false;
+                      const int numMessages = OSCTrafficStats::countMessages(packet.data, packet.size, isBundle);
+                      trafficStats.recordSend(packet.size, numMessages, isBundle, latencyUs);
+
+                      if (captureWriter != nullptr)
+                          captureWriter->record(captureIndex, packet.data, packet.size);
+
+                      ++numPacketsSent;
+                      numConsecutiveFailures = 0;
+                      backoffMs = 0.0;
+                      return;
+                  }
+
+                  ++numSendErrors;
+
+                  // 連續失敗：關閉 socket，以退避時間重新開啟（這個 while 迴圈隨即結束）
+                  if (++numConsecutiveFailures >= failuresBeforeReconnect)
+                      scheduleReconnect(nowMs);
+              }))
+    {
+        ++numServiced;
+    }
+
+    return numServiced;
+}
@@ -0,0 +1,166 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <atomic>
+#include <vector>
+#include "BoundedMPSCQueue.h"
+#include "OSCLatestValueTable.h"
+#include "OSCTrafficStats.h"
+
+class OSCCaptureWriter;
+
+//==============================================================================
+/**
+ * 單一 OSC 目的地
+ * 每個目的地有自己的啟用狀態、輸出格式（單獨訊息或 bundle）、最大發送頻率、
+ * 發送佇列、「最新值」槽位表與 UDP socket，所以一個慢或無法連線的目的地
+ * 只會讓自己的佇列滿出而丟棄封包，不會拖慢其他目的地。
+ *
+ * 生產端（enqueue / storeLatest）可以從任何線程呼叫，不上鎖、不配置記憶體；
+ * service() 只由 OSCTransmitter 的發送線程呼叫。
+ *
+ * socket 由發送線程建立：地址改變後在下一次 service() 時開啟，
+ * 連續發送失敗時關閉並以指數退避重新開啟，呼叫端（包括載入狀態）永遠不會等待網路。
+ * 重新連線期間佇列中的封包依設定丟棄或保留到恢復為止。
+ */
+class OSCDestination
+{
+public:
+    // 單一封包的最大大小：乙太網路 MTU 1500 減去 IPv4 與 UDP 標頭，避免 IP 分片
+    // （bundle 只在超過這個大小時拆開）
+    static constexpr int maxPacketSize = 1472;
+
+    // 連續值的最大發送頻率上限
+    static constexpr double maxAllowedRateHz = 1000.0;
+
+    struct Packet
+    {
+        int size = 0;
+        char data[maxPacketSize];
+    };
+
+    // 目的地設定（保存在插件狀態中）
+    struct Settings
+    {
+        juce::String ipAddress = "127.0.0.1";
+        int port = 4002;
+        bool enabled = true;
+        bool bundleMode = false;  // 每個 tick 的所有更新合併成一個帶 timetag 的 bundle
+        double maxRateHz = 0.0;   // 位置的最大發送頻率（每個球只送最新值），0 表示不限制
+        bool lookahead = false;   // 回放位置提前發送、以 timetag 排程（需要 bundle 模式且不限制頻率）
+        bool holdWhileReconnecting = false;  // 重新連線期間保留佇列中的封包（否則丟棄）
+    };
+
+    // 連線狀態（供 UI 顯示）
+    enum class Health
+    {
+        disabled,
+        connecting,     // 地址改變，等待發送線程開啟 socket
+        connected,
+        reconnecting    // 發送失敗，等待退避時間後重新開啟
+    };
+
+    static const char* getHealthName(Health health) noexcept;
+
+    // 連續失敗達到這個次數時關閉 socket 並重新連線
+    static constexpr int failuresBeforeReconnect = 3;
+
+    // 重新連線的退避時間（每次失敗加倍）
+    static constexpr double initialBackoffMs = 250.0;
+    static constexpr double maxBackoffMs = 10000.0;
+
+    OSCDestination();
+    ~OSCDestination();
+
+    // 套用設定（訊息線程）；地址在發送線程的下一次 service() 時生效
+    void applySettings(const Settings& settings, bool shouldBeEnabled);
+
+    bool isEnabled() const noexcept { return enabled.load(std::memory_order_relaxed); }
+    bool isBundleMode() const noexcept { return bundleMode.load(std::memory_order_relaxed); }
+    double getMaxRateHz() const noexcept { return maxRateHz.load(std::memory_order_relaxed); }
+    bool isCoalescing() const noexcept { return getMaxRateHz() > 0.0; }
+
+    // 是否接收提前排程的回放位置（而不是即時的回放位置）
+    bool isScheduled() const noexcept { return lookahead.load(std::memory_order_relaxed) && isBundleMode() && !isCoalescing(); }
+
+    Health getHealth() const noexcept { return health.load(std::memory_order_relaxed); }
+
+    // 下一次重新連線的時間（juce::Time::getMillisecondCounterHiRes()），只在 reconnecting 時有意義
+    double getRetryTimeMs() const noexcept { return retryTimeMs.load(std::memory_order_relaxed); }
+    int getNumConsecutiveFailures() const noexcept { return numConsecutiveFailures.load(std::memory_order_relaxed); }
+
+    // 把已編碼的封包放入這個目的地的佇列（任何線程）
+    bool enqueue(const char* packetData, int packetSize) noexcept;
+
+    // 以 key 保存最新的訊息（任何線程）；沒有啟用合併或槽位表已滿時返回 false
+    bool storeLatest(int key, const char* messageData, int messageSize) noexcept;
+
+    // 釋放不在 sortedKeys 中的最新值槽位（訊息線程，例如球被刪除後）
+    void retainLatestKeys(const std::vector<int>& sortedKeys) noexcept { latestValues.retainKeys(sortedKeys); }
+
+    // 發送線程：套用地址變更、依頻率送出最新值、最多送出 maxPackets 個封包
+    // 返回送出（或嘗試送出）的封包數
+    int service(int maxPackets);
+
+    // 統計（供 UI 顯示）
+    int getQueueDepth() const noexcept { return static_cast<int>(queue.getApproximateSize()); }
+    static constexpr int getQueueCapacity() noexcept { return static_cast<int>(queueCapacity); }
+    juce::uint64 getNumPacketsSent() const noexcept { return numPacketsSent.load(); }
+    juce::uint64 getNumPacketsDropped() const noexcept { return numPacketsDropped.load(); }
+    juce::uint64 getNumSendErrors() const noexcept { return numSendErrors.load(); }
+    juce::uint64 getNumCoalesced() const noexcept { return latestValues.getNumCoalesced(); }
+    juce::uint64 getNumLatestSlotsExhausted() const noexcept { return latestValues.getNumSlotsExhausted(); }
+
+    // 流量統計的快照（任何線程），包含丟棄數與目前的佇列深度
+    void getTrafficSnapshot(OSCTrafficStats::Snapshot& snapshot) const noexcept;
+
+    // 送出的封包交給擷取（發送線程啟動前設定一次）；index 是寫入擷取檔的目的地索引
+    void setCaptureWriter(OSCCaptureWriter* writer, int index) noexcept { captureWriter = writer; captureIndex = index; }
+
+private:
+    static constexpr size_t queueCapacity = 512;
+
+    BoundedMPSCQueue<Packet, queueCapacity> queue;
+    OSCLatestValueTable latestValues;
+    OSCTrafficStats trafficStats;
+
+    std::atomic<bool> enabled { false };
+    std::atomic<bool> bundleMode { false };
+    std::atomic<double> maxRateHz { 0.0 };
+    std::atomic<bool> lookahead { false };
+    std::atomic<bool> holdWhileReconnecting { false };
+    std::atomic<Health> health { Health::disabled };
+    std::atomic<double> retryTimeMs { 0.0 };
+    std::atomic<int> numConsecutiveFailures { 0 };
+    std::atomic<juce::uint64> numPacketsSent { 0 };
+    std::atomic<juce::uint64> numPacketsDropped { 0 };
+    std::atomic<juce::uint64> numSendErrors { 0 };
+
+    // 地址只在訊息線程寫入、發送線程讀取
+    juce::CriticalSection addressLock;
+    juce::String pendingHost;
+    int pendingPort = 0;
+    std::atomic<bool> addressChanged { false };
+
+    // 以下只在發送線程中使用：每個目的地一個 socket，各自快取解析過的地址
+    std::unique_ptr<juce::DatagramSocket> socket;
+    juce::String host;
+    int port = 0;
+    double nextDrainTimeMs = 0.0;
+    double backoffMs = 0.0;
+
+    OSCCaptureWriter* captureWriter = nullptr;
+    int captureIndex = 0;
+
+    // 把槽位表中的最新值放入佇列，返回送出的數量
+    int drainLatestValues();
+
+    // 連線管理（發送線程）：需要時開啟 socket，返回是否可以發送
+    bool updateConnection(double nowMs);
+    void scheduleReconnect(double nowMs);
+
+    // 丟棄佇列中所有的封包，返回丟棄的數量
+    int discardQueue() noexcept;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(OSCDestination)
+};
@@ -0,0 +1,145 @@
+#include "OSCInputReceiver.h"
+#include "OSCPacketReader.h"
+#include "DebugLogger.h"
+#include <algorithm>
+#include <cmath>
+
+//==============================================================================
+OSCInputReceiver::OSCInputReceiver()
+    : juce::Thread("JYPad OSC Receiver")
+{
+    startThread(juce::Thread::Priority::high);
+}
+
+OSCInputReceiver::~OSCInputReceiver()
+{
+    stopThread(1000);
+}
+
+//==============================================================================
+void OSCInputReceiver::setPort(int portNumber, bool shouldBeEnabled)
+{
+    if (port.load() == portNumber && enabled.load() == shouldBeEnabled)
+        return;
+
+    port = portNumber;
+    enabled = shouldBeEnabled;
+    portChanged = true;
+    notify();
+
+    DEBUG_LOG("OSCInputReceiver: Port " + juce::String(portNumber) + (shouldBeEnabled ? " (enabled)" : " (disabled)"));
+}
+
+void OSCInputReceiver::setRoutes(const std::vector<Route>& routes)
+{
+    auto newTable = std::make_shared<RoutingTable>();
+    for (const auto& route : routes)
+    {
+        if (!newTable->router.add(route.address.toRawUTF8(), route.ballId))
+            DEBUG_LOG_ERROR("OSCInputReceiver: Invalid OSC address: " + route.address);
+
+        if (route.isRecording)
+            newTable->recordingBallIds.push_back(route.ballId);
+    }
+    std::sort(newTable->recordingBallIds.begin(), newTable->recordingBallIds.end());
+
+    std::shared_ptr<const RoutingTable> newTableConst = std::move(newTable);
+    {
+        const juce::SpinLock::ScopedLockType lock(routingTableLock);
+        std::swap(routingTable, newTableConst);
+    }
+    // 舊的路由表在鎖外釋放
+}
+
+bool OSCInputReceiver::RoutingTable::isRecording(int ballId) const noexcept
+{
+    return std::binary_search(recordingBallIds.begin(), recordingBallIds.end(), ballId);
+}
+
+//==============================================================================
+void OSCInputReceiver::run()
+{
+    // socket 只在這個線程中建立與使用
+    std::unique_ptr<juce::DatagramSocket> socket;
+    juce::HeapBlock<char> buffer(static_cast<size_t>(maxPacketSize));
+
+    while (!threadShouldExit())
+    {
+        if (portChanged.exchange(false))
+        {
+            socket.reset();
+            bound = false;
+
+            const int portNumber = port.load();
+            if (isEnabled() && portNumber > 0 && portNumber < 65536)
+            {
+                socket = std::make_unique<juce::DatagramSocket>(false);
+                if (socket->bindToPort(portNumber))
+                {
+                    bound = true;
+                    DEBUG_LOG("OSCInputReceiver: Listening on port " + juce::String(portNumber));
+                }
+                else
+                {
+                    DEBUG_LOG_ERROR("OSCInputReceiver: Failed to bind port " + juce::String(portNumber));
+                    socket.reset();
+                }
+            }
+        }
+
+        if (socket == nullptr)
+        {
+            wait(100);  // 沒有監聽：等待 setPort() 的 notify()
+            continue;
+        }
+
+        if (socket->waitUntilReady(true, receiveTimeoutMs) <= 0)
+            continue;
+
+        const int bytesRead = socket->read(buffer.get(), maxPacketSize, false);
+        if (bytesRead > 0)
+            handlePacket(buffer.get(), bytesRead, juce::Time::getMillisecondCounterHiRes());
+    }
+}
+
+void OSCInputReceiver::handlePacket(const char* data, int size, double arrivalTimeMs)
+{
+    ++numPacketsReceived;
+
+    std::shared_ptr<const RoutingTable> table;
+    {
+        const juce::SpinLock::ScopedLockType lock(routingTableLock);
+        table = routingTable;
+    }
+
+    const bool wellFormed = OSCPacketReader::forEachMessage(data, size, [this, &table, arrivalTimeMs](const OSCPacketReader::Message& message)
+    {
+        float x = 0.0f, y = 0.0f;
+        if (table == nullptr
+            || !message.getFloat(0, x) || !message.getFloat(1, y)
+            || !std::isfinite(x) || !std::isfinite(y))
+        {
+            ++numIgnoredMessages;
+            return;
+        }
+
+        const int numMatched = table->router.match(message.address, [this, &table, x, y, arrivalTimeMs](int ballId)
+        {
+            double timeMs = arrivalTimeMs;
+            if (jitterBuffer.push(ballId, x, y, arrivalTimeMs, timeMs))
+                ++numPositionsReceived;
+            else
+                ++numIgnoredMessages;  // 球的數量超過槽位數
+
+            // 錄製不經過重新取樣，每一個位置都保留（時間使用平滑後的到達時間）
+            if (onRecordPosition != nullptr && table->isRecording(ballId))
+                onRecordPosition(ballId, x, y, timeMs);
+        });
+
+        if (numMatched == 0)
+            ++numIgnoredMessages;
+    });
+
+    if (!wellFormed)
+        ++numMalformedPackets;
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <atomic>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "OSCAddressRouter.h"
+#include "PositionJitterBuffer.h"
+
+//==============================================================================
+/**
+ * OSC 輸入線程
+ * 在自己的線程中接收 UDP 封包並解碼（不經過訊息線程），
+ * 以預先編譯的路由表（OSCAddressRouter）把 {prefix}/xy x y 訊息對應到球的 ID，
+ * 再放入每個球的抖動緩衝（PositionJitterBuffer），平滑到達時間並估計發送端的時鐘。
+ * 地址可以使用 OSC 萬用字元，例如 /track/{1,2,3}/xy 同時移動三個球。
+ *
+ * renderPositions() 由音訊線程（或任何單一消費者線程）在每個 block 呼叫，
+ * 取得重新取樣後的穩定位置並套用到 JYPad。
+ * 處於錄製狀態的球另外在接收線程中逐一回調 onRecordPosition（不合併），
+ * 附上平滑後的到達時間，用來以完整的感測器頻率錄製。
+ */
+class OSCInputReceiver : private juce::Thread
+{
+public:
+    struct Route
+    {
+        juce::String address;   // 完整地址，例如 "/track/1/xy"
+        int ballId;
+        bool isRecording;       // 是否擷取這個球收到的每一個位置
+    };
+
+    OSCInputReceiver();
+    ~OSCInputReceiver() override;
+
+    // 設定監聽的 port（訊息線程）；在接收線程中重新綁定
+    void setPort(int portNumber, bool shouldBeEnabled);
+    bool isEnabled() const noexcept { return enabled.load(std::memory_order_relaxed); }
+    bool isBound() const noexcept { return bound.load(std::memory_order_relaxed); }
+
+    // 以新的來源列表重建路由表（在呼叫端線程建立，再整份替換；來源改變時呼叫）
+    void setRoutes(const std::vector<Route>& routes);
+
+    // 錄製中的球收到位置時在接收線程中呼叫
+    // timeMs 為平滑後的到達時間（juce::Time::getMillisecondCounterHiRes() 的時間軸）
+    // 必須在 setPort() 啟用之前設定，之後不能再修改
+    std::function<void(int ballId, float x, float y, double timeMs)> onRecordPosition;
+
+    // 以 nowMs（juce::Time::getMillisecondCounterHiRes()）時刻的播放位置，
+    // 對每個輸出有變化的球呼叫 consume(int ballId, float x, float y)（單一消費者）
+    template <typename Consume>
+    int renderPositions(double nowMs, Consume&& consume) noexcept
+    {
+        return jitterBuffer.render(nowMs, consume);
+    }
+
+    // 統計（供 UI 顯示）
+    juce::uint64 getNumPacketsReceived() const noexcept { return numPacketsReceived.load(); }
+    juce::uint64 getNumPositionsReceived() const noexcept { return numPositionsReceived.load(); }
+    juce::uint64 getNumIgnoredMessages() const noexcept { return numIgnoredMessages.load(); }
+    juce::uint64 getNumMalformedPackets() const noexcept { return numMalformedPackets.load(); }
+    PositionJitterBuffer::Stats getJitterStats() const noexcept { return jitterBuffer.getStats(); }
+    juce::uint64 getNumUnderruns() const noexcept { return jitterBuffer.getNumUnderruns(); }
+
+private:
+    // 每個球的抖動緩衝（接收線程寫入，音訊線程讀取）
+    PositionJitterBuffer jitterBuffer;
+
+    // 路由表與錄製中的球（一起替換，接收線程看到的永遠是一致的一份）
+    struct RoutingTable
+    {
+        OSCAddressRouter router;
+        std::vector<int> recordingBallIds;  // 已排序
+
+        bool isRecording(int ballId) const noexcept;
+    };
+
+    // 目前的路由表（接收線程每個封包取一次參考）
+    std::shared_ptr<const RoutingTable> routingTable;
+    juce::SpinLock routingTableLock;
+
+    std::atomic<int> port { 0 };
+    std::atomic<bool> enabled { false };
+    std::atomic<bool> portChanged { false };
+    std::atomic<bool> bound { false };
+
+    std::atomic<juce::uint64> numPacketsReceived { 0 };
+    std::atomic<juce::uint64> numPositionsReceived { 0 };
+    std::atomic<juce::uint64> numIgnoredMessages { 0 };
+    std::atomic<juce::uint64> numMalformedPackets { 0 };
+
+    // UDP 封包的最大大小
+    static constexpr int maxPacketSize = 65536;
+
+    // 等待封包的逾時（毫秒），用於定期檢查 port 變更與線程結束
+    static constexpr int receiveTimeoutMs = 50;
+
+    void run() override;
+    void handlePacket(const char* data, int size, double arrivalTimeMs);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(OSCInputReceiver)
+};
@@ -0,0 +1,112 @@
+#include "OSCLatestValueTable.h"
+#include <algorithm>
+#include <cstring>
+
+//==============================================================================
+OSCLatestValueTable::OSCLatestValueTable()
+    : slots(new Slot[numSlots])
+{
+    static_assert((numSlots & (numSlots - 1)) == 0, "numSlots must be a power of two");
+}
+
+//==============================================================================
+OSCLatestValueTable::Slot* OSCLatestValueTable::findOrClaimSlot(int key) noexcept
+{
+    constexpr juce::uint32 mask = static_cast<juce::uint32>(numSlots - 1);
+    juce::uint32 index = (static_cast<juce::uint32>(key) * 2654435761u) & mask;
+
+    // 線性探測；已刪除的槽位不中斷探測（key 可能在它之後），
+    // 直到遇到空槽位才確定 key 不存在，然後佔用第一個可用的槽位
+    // 同一個 key 的所有寫入者依相同的順序探測，所以會佔用同一個槽位
+    for (;;)
+    {
+        Slot* available = nullptr;
+        juce::uint32 probeIndex = index;
+
+        for (int probe = 0; probe < numSlots; ++probe)
+        {
+            Slot& slot = slots[probeIndex];
+            const int existing = slot.key.load(std::memory_order_acquire);
+
+            if (existing == key)
+                return &slot;
+
+            if (existing == deletedKey && available == nullptr)
+                available = &slot;
+
+            if (existing == emptyKey)
+            {
+                if (available == nullptr)
+                    available = &slot;
+                break;
+            }
+
+            probeIndex = (probeIndex + 1) & mask;
+        }
+
+        if (available == nullptr)
+            return nullptr;
+
+        int expected = available->key.load(std::memory_order_acquire);
+        if ((expected == emptyKey || expected == deletedKey)
+            && available->key.compare_exchange_strong(expected, key, std::memory_order_acq_rel))
+            return available;
+
+        // 其他線程剛好佔用了這個槽位，可能就是同一個 key
+        if (expected == key)
+            return available;
+
+        // 被其他 key 佔用：重新探測
+    }
+}
+
+void OSCLatestValueTable::retainKeys(const std::vector<int>& sortedKeys) noexcept
+{
+    for (int i = 0; i < numSlots; ++i)
+    {
+        Slot& slot = slots[static_cast<size_t>(i)];
+        const int key = slot.key.load(std::memory_order_acquire);
+
+        if (key == emptyKey || key == deletedKey || std::binary_search(sortedKeys.begin(), sortedKeys.end(), key))
+            continue;
+
+        slot.dirty.store(false, std::memory_order_relaxed);
+        slot.key.store(deletedKey, std::memory_order_release);
+    }
+}
+
+bool OSCLatestValueTable::store(int key, const char* messageData, int messageSize) noexcept
+{
+    if (key == emptyKey || key == deletedKey || messageSize <= 0 || messageSize > maxMessageSize)
+        return false;
+
+    Slot* slot = findOrClaimSlot(key);
+    if (slot == nullptr)
+    {
+        numSlotsExhausted.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    // 取得寫入權（序號變為奇數）；同一個球幾乎不會同時從兩個線程寫入，
+    // 競爭時只需等待另一個寫入者完成一次短暫的 memcpy
+    juce::uint32 sequence = slot->sequence.load(std::memory_order_relaxed);
+    for (;;)
+    {
+        if ((sequence & 1) == 0
+            && slot->sequence.compare_exchange_weak(sequence, sequence + 1, std::memory_order_acquire))
+            break;
+
+        sequence = slot->sequence.load(std::memory_order_relaxed);
+    }
+
+    std::atomic_thread_fence(std::memory_order_release);
+    slot->size = messageSize;
+    std::memcpy(slot->data, messageData, static_cast<size_t>(messageSize));
+    slot->sequence.store(sequence + 2, std::memory_order_release);
+
+    // 上一個值還沒有被送出：被這次覆蓋
+    if (slot->dirty.exchange(true, std::memory_order_release))
+        numCoalesced.fetch_add(1, std::memory_order_relaxed);
+
+    return true;
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <atomic>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <vector>
+
+//==============================================================================
+/**
+ * 「最新值優先」的 OSC 訊息槽位表
+ * 每個 key（例如球的 ID）有一個槽位，只保存最新編碼好的訊息；
+ * 發送線程定期 drain() 時只會看到每個 key 的最新值，中間的位置直接被覆蓋，
+ * 因此負載高時頻寬與延遲都有上限，而不會在佇列中累積。
+ *
+ * store() 可以從任何線程呼叫（不配置記憶體）；drain() 只能由單一消費者線程呼叫。
+ * 每個槽位以 seqlock 保護：寫入者把序號設為奇數後寫入，寫完再設為偶數；
+ * 讀取者發現序號改變時放棄這次讀取，留待下一次 drain。
+ *
+ * 不再使用的 key（例如被刪除的球）以 retainKeys() 釋放，槽位標記為已刪除，
+ * 之後新的 key 可以重新佔用，新增 / 刪除球多次後表也不會被用完。
+ */
+class OSCLatestValueTable
+{
+public:
+    // 單一訊息的最大大小（位置訊息只有地址 + 兩個 float）
+    static constexpr int maxMessageSize = 256;
+    static constexpr int numSlots = 512;
+
+    OSCLatestValueTable();
+
+    // 以 key 保存最新的訊息；訊息太大或槽位已滿時返回 false（呼叫者應改用一般佇列）
+    bool store(int key, const char* messageData, int messageSize) noexcept;
+
+    // 對每個有新值的槽位呼叫 consume(const char* data, int size)，返回處理的數量
+    template <typename Consume>
+    int drain(Consume&& consume) noexcept
+    {
+        char message[maxMessageSize];
+        int numDrained = 0;
+
+        for (int i = 0; i < numSlots; ++i)
+        {
+            Slot& slot = slots[static_cast<size_t>(i)];
+
+            if (!slot.dirty.exchange(false, std::memory_order_acquire))
+                continue;
+
+            const juce::uint32 before = slot.sequence.load(std::memory_order_acquire);
+            const int size = slot.size;
+            if ((before & 1) == 0 && size > 0 && size <= maxMessageSize)
+                std::memcpy(message, slot.data, static_cast<size_t>(size));
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+
+            if ((before & 1) != 0 || slot.sequence.load(std::memory_order_relaxed) != before)
+            {
+                // 寫入者正在更新這個槽位，它寫完後會再次標記 dirty
+                slot.dirty.store(true, std::memory_order_relaxed);
+                continue;
+            }
+
+            consume(static_cast<const char*>(message), size);
+            ++numDrained;
+        }
+
+        return numDrained;
+    }
+
+    // 釋放不在 sortedKeys（已排序）中的 key 的槽位，未送出的值一併丟棄
+    // 只能由單一線程呼叫（訊息線程），而且被釋放的 key 之後不應該再被 store()
+    void retainKeys(const std::vector<int>& sortedKeys) noexcept;
+
+    // 被較新的值覆蓋而沒有送出的訊息數（統計用）
+    juce::uint64 getNumCoalesced() const noexcept { return numCoalesced.load(std::memory_order_relaxed); }
+
+    // 槽位用完而無法保存的訊息數（統計用；這些訊息改走一般佇列，不會合併）
+    juce::uint64 getNumSlotsExhausted() const noexcept { return numSlotsExhausted.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr int emptyKey = std::numeric_limits<int>::min();
+    static constexpr int deletedKey = emptyKey + 1;
+
+    struct Slot
+    {
+        std::atomic<int> key { emptyKey };
+        std::atomic<juce::uint32> sequence { 0 };
+        std::atomic<bool> dirty { false };
+        int size = 0;
+        char data[maxMessageSize];
+    };
+
+    std::unique_ptr<Slot[]> slots;
+    std::atomic<juce::uint64> numCoalesced { 0 };
+    std::atomic<juce::uint64> numSlotsExhausted { 0 };
+
+    // 找到 key 的槽位（必要時佔用一個空槽位）；表已滿時返回 nullptr
+    Slot* findOrClaimSlot(int key) noexcept;
+
+    JUCE_DECLARE_NON_COPYABLE(OSCLatestValueTable)
+};
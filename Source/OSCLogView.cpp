@@ -0,0 +1,212 @@
+#include "OSCLogView.h"
+
+//==============================================================================
+OSCLogView::OSCLogView(PlugDataCustomObjectAudioProcessor& processor)
+    : audioProcessor(processor)
+{
+    pauseButton.setButtonText("Pause");
+    pauseButton.setClickingTogglesState(true);
+    pauseButton.onClick = [this] {
+        pauseButton.setButtonText(pauseButton.getToggleState() ? "Resume" : "Pause");
+    };
+    addAndMakeVisible(&pauseButton);
+
+    filterEditor.setTextToShowWhenEmpty("Filter address", juce::Colours::grey);
+    filterEditor.setFont(juce::Font(juce::FontOptions().withHeight(12.0f)));
+    filterEditor.setColour(juce::TextEditor::backgroundColourId, juce::Colour(0xff2a2a2a));
+    filterEditor.setColour(juce::TextEditor::textColourId, juce::Colours::white);
+    filterEditor.onTextChange = [this] {
+        filterText = filterEditor.getText().trim();
+        applyFilter();
+    };
+    addAndMakeVisible(&filterEditor);
+
+    listBox.setModel(this);
+    listBox.setRowHeight(14);
+    listBox.setColour(juce::ListBox::backgroundColourId, juce::Colour(0xff2a2a2a));
+    addAndMakeVisible(&listBox);
+
+    // 從目前的記錄開始（開啟前的記錄只保留在記錄環中）
+    nextReadIndex = OSCMessageLog::getOldestRetained(audioProcessor.oscMessageLog.getNumWritten());
+
+    startTimer(refreshIntervalMs);
+}
+
+OSCLogView::~OSCLogView()
+{
+    stopTimer();
+    listBox.setModel(nullptr);
+}
+
+void OSCLogView::resized()
+{
+    auto area = getLocalBounds();
+
+    auto toolbar = area.removeFromTop(22);
+    pauseButton.setBounds(toolbar.removeFromLeft(70));
+    toolbar.removeFromLeft(5);
+    filterEditor.setBounds(toolbar.removeFromLeft(200));
+
+    area.removeFromTop(4);
+    listBox.setBounds(area);
+}
+
+//==============================================================================
+void OSCLogView::timerCallback()
+{
+    if (pauseButton.getToggleState())
+        return;
+
+    // 來源的前綴或編號改變後地址不同：以新的地址重新篩選
+    const auto revision = audioProcessor.jyPad.getBallLayoutRevision();
+    if (revision != filterBallLayoutRevision)
+    {
+        filterBallLayoutRevision = revision;
+        if (filterText.isNotEmpty())
+            applyFilter();
+    }
+
+    if (!readNewEntries())
+        return;
+
+    listBox.updateContent();
+    listBox.scrollToEnsureRowIsOnscreen(getNumRows() - 1);
+    listBox.repaint();
+}
+
+bool OSCLogView::readNewEntries()
+{
+    const auto& log = audioProcessor.oscMessageLog;
+    const juce::uint64 numWritten = log.getNumWritten();
+
+    // 暫停或負載太高時被覆蓋的記錄直接跳過
+    nextReadIndex = juce::jmax(nextReadIndex, OSCMessageLog::getOldestRetained(numWritten));
+
+    bool hasNewRows = false;
+
+    for (; nextReadIndex < numWritten; ++nextReadIndex)
+    {
+        // 還在寫入中（或剛好被覆蓋）：留到下一次，之後的記錄也一起等待以保持順序
+        OSCMessageLog::Entry entry;
+        if (!log.read(nextReadIndex, entry))
+            break;
+
+        entries.push_back(entry);
+        const juce::uint64 localIndex = firstIndex + entries.size() - 1;
+
+        if (filterText.isEmpty() || matchesFilter(entry))
+        {
+            if (filterText.isNotEmpty())
+                filteredIndices.push_back(localIndex);
+
+            hasNewRows = true;
+        }
+    }
+
+    // 只保留最近的 capacity 筆
+    while (entries.size() > static_cast<size_t>(OSCMessageLog::capacity))
+    {
+        entries.pop_front();
+        ++firstIndex;
+    }
+
+    while (!filteredIndices.empty() && filteredIndices.front() < firstIndex)
+        filteredIndices.pop_front();
+
+    return hasNewRows;
+}
+
+//==============================================================================
+void OSCLogView::applyFilter()
+{
+    filterBallLayoutRevision = audioProcessor.jyPad.getBallLayoutRevision();
+    filterCache.clear();
+    filteredIndices.clear();
+
+    if (filterText.isNotEmpty())
+    {
+        for (size_t i = 0; i < entries.size(); ++i)
+            if (matchesFilter(entries[i]))
+                filteredIndices.push_back(firstIndex + i);
+    }
+
+    listBox.updateContent();
+    listBox.scrollToEnsureRowIsOnscreen(getNumRows() - 1);
+    listBox.repaint();
+}
+
+bool OSCLogView::matchesFilter(const OSCMessageLog::Entry& entry)
+{
+    // 同一個球、同一種訊息的地址相同，只比對一次
+    const int key = entry.ballId * 4 + static_cast<int>(entry.kind);
+
+    auto it = filterCache.find(key);
+    if (it == filterCache.end())
+        it = filterCache.emplace(key, formatAddress(entry).containsIgnoreCase(filterText)).first;
+
+    return it->second;
+}
+
+juce::String OSCLogView::formatAddress(const OSCMessageLog::Entry& entry) const
+{
+    // 只在訊息線程中讀取球的前綴（與 UI 的其他部分相同）
+    const Ball* ball = audioProcessor.jyPad.getBall(entry.ballId);
+    if (ball == nullptr)
+        return "(source " + juce::String(entry.ballId) + ")";
+
+    switch (entry.kind)
+    {
+        case OSCMessageLog::Kind::position: return ball->oscPrefix + "/xy";
+        case OSCMessageLog::Kind::mute:     return PlugDataCustomObjectAudioProcessor::getMuteSoloAddressPrefix(*ball) + "/mute";
+        case OSCMessageLog::Kind::solo:     return PlugDataCustomObjectAudioProcessor::getMuteSoloAddressPrefix(*ball) + "/solo";
+    }
+
+    return {};
+}
+
+const OSCMessageLog::Entry* OSCLogView::getEntryForRow(int row) const noexcept
+{
+    if (row < 0)
+        return nullptr;
+
+    juce::uint64 index = firstIndex + static_cast<juce::uint64>(row);
+    if (filterText.isNotEmpty())
+    {
+        if (static_cast<size_t>(row) >= filteredIndices.size())
+            return nullptr;
+
+        index = filteredIndices[static_cast<size_t>(row)];
+    }
+
+    if (index < firstIndex || index - firstIndex >= entries.size())
+        return nullptr;
+
+    return &entries[static_cast<size_t>(index - firstIndex)];
+}
+
+//==============================================================================
+int OSCLogView::getNumRows()
+{
+    return static_cast<int>(filterText.isNotEmpty() ? filteredIndices.size() : entries.size());
+}
+
+void OSCLogView::paintListBoxItem(int rowNumber, juce::Graphics& g, int width, int height, bool rowIsSelected)
+{
+    if (rowIsSelected)
+        g.fillAll(juce::Colour(0xff404040));
+
+    const auto* entry = getEntryForRow(rowNumber);
+    if (entry == nullptr)
+        return;
+
+    // 只有看得到的列才格式化
+    juce::String text = juce::String(entry->timeMs / 1000.0, 3) + "  " + formatAddress(*entry);
+    if (entry->kind == OSCMessageLog::Kind::position)
+        text << " " << juce::String(entry->values[0], 2) << " " << juce::String(entry->values[1], 2);
+    else
+        text << " " << juce::roundToInt(entry->values[0]);
+
+    g.setColour(juce::Colours::white);
+    g.setFont(juce::Font(juce::FontOptions().withHeight(12.0f)));
+    g.drawText(text, 4, 0, width - 8, height, juce::Justification::centredLeft, true);
+}
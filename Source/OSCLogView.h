@@ -0,0 +1,66 @@
+#pragma once
+
+#include <juce_gui_basics/juce_gui_basics.h>
+#include <deque>
+#include <unordered_map>
+#include "PluginProcessor.h"
+
+//==============================================================================
+/**
+ * OSC 訊息記錄的虛擬化列表
+ * 定期把記錄環（OSCMessageLog）中的新記錄複製到本地（最多 OSCMessageLog::capacity 筆），
+ * ListBox 只在繪製看得到的列時才格式化文字，所以記錄的數量不影響訊息線程的負擔。
+ *
+ * Pause 停止讀取新的記錄（暫停期間被覆蓋的記錄不會顯示）；
+ * Filter 只顯示地址包含該文字的記錄（不分大小寫）。
+ */
+class OSCLogView : public juce::Component,
+                   private juce::ListBoxModel,
+                   private juce::Timer
+{
+public:
+    explicit OSCLogView(PlugDataCustomObjectAudioProcessor& processor);
+    ~OSCLogView() override;
+
+    void resized() override;
+
+private:
+    PlugDataCustomObjectAudioProcessor& audioProcessor;
+
+    juce::TextButton pauseButton;
+    juce::TextEditor filterEditor;
+    juce::ListBox listBox;
+
+    // 本地的記錄；本地序號連續遞增，entries.front() 的序號為 firstIndex
+    std::deque<OSCMessageLog::Entry> entries;
+    juce::uint64 firstIndex = 0;
+    juce::uint64 nextReadIndex = 0;   // 下一筆要從記錄環讀取的序號（記錄環的序號）
+
+    // 篩選後的列（entries 中的序號）；沒有篩選時直接對應 entries
+    std::deque<juce::uint64> filteredIndices;
+    juce::String filterText;
+
+    // 每個（球、種類）是否符合篩選，篩選或球的前綴改變時清除
+    std::unordered_map<int, bool> filterCache;
+    juce::uint32 filterBallLayoutRevision = 0;
+
+    // 讀取新記錄的間隔
+    static constexpr int refreshIntervalMs = 100;
+
+    void timerCallback() override;
+
+    // 從記錄環讀取新的記錄，返回是否有新的列
+    bool readNewEntries();
+
+    void applyFilter();
+    bool matchesFilter(const OSCMessageLog::Entry& entry);
+    juce::String formatAddress(const OSCMessageLog::Entry& entry) const;
+
+    const OSCMessageLog::Entry* getEntryForRow(int row) const noexcept;
+
+    // ListBoxModel
+    int getNumRows() override;
+    void paintListBoxItem(int rowNumber, juce::Graphics& g, int width, int height, bool rowIsSelected) override;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(OSCLogView)
+};
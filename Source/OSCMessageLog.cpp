@@ -0,0 +1,41 @@
+#include "OSCMessageLog.h"
+
+//==============================================================================
+OSCMessageLog::OSCMessageLog()
+    : slots(new Slot[capacity])
+{
+    static_assert((capacity & (capacity - 1)) == 0, "capacity must be a power of two");
+}
+
+//==============================================================================
+void OSCMessageLog::push(Kind kind, int ballId, float value0, float value1) noexcept
+{
+    // 每個生產者取得自己的序號；相差一整圈的兩個寫入者幾乎不可能同時寫同一個槽位，
+    // 發生時讀取端的序號驗證會讓那筆記錄讀取失敗
+    const juce::uint64 index = writeIndex.fetch_add(1, std::memory_order_acq_rel);
+    Slot& slot = slots[static_cast<size_t>(index & (capacity - 1))];
+
+    slot.sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot.entry.timeMs = juce::Time::getMillisecondCounterHiRes();
+    slot.entry.ballId = ballId;
+    slot.entry.kind = kind;
+    slot.entry.values[0] = value0;
+    slot.entry.values[1] = value1;
+
+    slot.sequence.store(index + 1, std::memory_order_release);
+}
+
+bool OSCMessageLog::read(juce::uint64 index, Entry& entry) const noexcept
+{
+    const Slot& slot = slots[static_cast<size_t>(index & (capacity - 1))];
+
+    if (slot.sequence.load(std::memory_order_acquire) != index + 1)
+        return false;
+
+    entry = slot.entry;
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return slot.sequence.load(std::memory_order_relaxed) == index + 1;
+}
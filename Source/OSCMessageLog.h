@@ -0,0 +1,63 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <atomic>
+#include <memory>
+
+//==============================================================================
+/**
+ * 送出的 OSC 訊息的二進位記錄環
+ * 發送端只寫入固定大小的記錄（時間、球、種類、數值），不組字串；
+ * 環滿了就覆蓋最舊的記錄，所以寫入永遠不會失敗或阻塞。
+ *
+ * push() 可以從任何線程呼叫（多生產者，不上鎖、不配置記憶體）。
+ * 讀取端以遞增的序號讀取，每個槽位以序號驗證：正在寫入或已被覆蓋的記錄讀取失敗。
+ * 顯示時才由 UI 把看得到的記錄格式化成文字。
+ */
+class OSCMessageLog
+{
+public:
+    static constexpr int capacity = 4096;
+
+    enum class Kind : juce::uint8
+    {
+        position,   // {prefix}/xy x y
+        mute,       // .../mute value
+        solo        // .../solo value
+    };
+
+    struct Entry
+    {
+        double timeMs = 0.0;  // juce::Time::getMillisecondCounterHiRes()
+        int ballId = 0;
+        Kind kind = Kind::position;
+        float values[2] = { 0.0f, 0.0f };
+    };
+
+    OSCMessageLog();
+
+    // 加入一筆記錄（任何線程）
+    void push(Kind kind, int ballId, float value0, float value1 = 0.0f) noexcept;
+
+    // 已寫入的記錄總數（下一筆的序號）；仍保留的最舊序號為 max(0, total - capacity)
+    juce::uint64 getNumWritten() const noexcept { return writeIndex.load(std::memory_order_acquire); }
+    static juce::uint64 getOldestRetained(juce::uint64 numWritten) noexcept
+    {
+        return numWritten > static_cast<juce::uint64>(capacity) ? numWritten - static_cast<juce::uint64>(capacity) : 0;
+    }
+
+    // 讀取序號為 index 的記錄；還沒寫完或已被覆蓋時返回 false
+    bool read(juce::uint64 index, Entry& entry) const noexcept;
+
+private:
+    struct Slot
+    {
+        std::atomic<juce::uint64> sequence { 0 };  // 寫入完成後為 index + 1，寫入中為 0
+        Entry entry;
+    };
+
+    std::unique_ptr<Slot[]> slots;
+    std::atomic<juce::uint64> writeIndex { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE(OSCMessageLog)
+};
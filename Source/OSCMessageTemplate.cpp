@@ -0,0 +1,32 @@
+#include "OSCMessageTemplate.h"
+#include "OSCPacketWriter.h"
+#include <cstring>
+
+//==============================================================================
+bool OSCMessageTemplate::set(std::initializer_list<const char*> addressParts, const char* typeTags) noexcept
+{
+    OSCPacketWriter writer(header, maxMessageSize);
+    writer.beginMessage(addressParts, typeTags);
+
+    headerSize = writer.getSize();
+    numArguments = static_cast<int>(std::strlen(typeTags));
+    return isValid();
+}
+
+int OSCMessageTemplate::writeFloats(char* destination, int destinationSize, std::initializer_list<float> values) const noexcept
+{
+    jassert(static_cast<int>(values.size()) == numArguments);
+
+    const int messageSize = headerSize + numArguments * 4;
+    if (!isValid() || static_cast<int>(values.size()) != numArguments || messageSize > destinationSize)
+        return 0;
+
+    std::memcpy(destination, header, static_cast<size_t>(headerSize));
+
+    // 只有參數需要在每次發送時編碼
+    OSCPacketWriter writer(destination + headerSize, destinationSize - headerSize);
+    for (const float value : values)
+        writer.writeFloat32(value);
+
+    return writer.isValid() ? messageSize : 0;
+}
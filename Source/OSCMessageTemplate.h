@@ -0,0 +1,35 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <initializer_list>
+
+//==============================================================================
+/**
+ * 預先編碼好的 OSC 訊息樣板
+ * 地址（已補齊到 4 bytes）與型別標籤只在 set() 時編碼一次，
+ * 發送時只需要複製樣板並寫入 float 參數，不配置記憶體、不組字串。
+ *
+ * 用法：
+ *   tmpl.set ({ prefix.toRawUTF8(), "/xy" }, "ff");   // 前綴改變時
+ *   const int size = tmpl.writeFloats (packet, sizeof (packet), { x, y });
+ */
+class OSCMessageTemplate
+{
+public:
+    // 樣板與完整訊息的最大大小
+    static constexpr int maxMessageSize = 256;
+
+    // 重新編碼地址與型別標籤；地址太長時返回 false，之後的 writeFloats() 都會失敗
+    bool set(std::initializer_list<const char*> addressParts, const char* typeTags) noexcept;
+
+    bool isValid() const noexcept { return headerSize > 0; }
+
+    // 寫入樣板與 float 參數，返回訊息大小（失敗時返回 0）
+    // values 的數量必須與型別標籤一致
+    int writeFloats(char* destination, int destinationSize, std::initializer_list<float> values) const noexcept;
+
+private:
+    char header[maxMessageSize] {};
+    int headerSize = 0;
+    int numArguments = 0;
+};
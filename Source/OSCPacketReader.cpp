@@ -0,0 +1,175 @@
+#include "OSCPacketReader.h"
+#include <cstring>
+
+//==============================================================================
+namespace
+{
+    // 返回以 '\0' 結尾並補齊到 4 bytes 的字串所佔的大小；沒有結尾時返回 -1
+    int paddedStringSize(const char* data, int available) noexcept
+    {
+        const auto* end = static_cast<const char*>(std::memchr(data, 0, static_cast<size_t>(available)));
+        if (end == nullptr)
+            return -1;
+
+        const int size = ((static_cast<int>(end - data) + 1) + 3) & ~3;
+        return size <= available ? size : -1;
+    }
+
+    juce::uint64 readBigEndian64(const char* bytes) noexcept
+    {
+        return (static_cast<juce::uint64>(OSCPacketReader::readBigEndian32(bytes)) << 32)
+             | OSCPacketReader::readBigEndian32(bytes + 4);
+    }
+}
+
+//==============================================================================
+juce::uint32 OSCPacketReader::readBigEndian32(const char* bytes) noexcept
+{
+    const auto* b = reinterpret_cast<const juce::uint8*>(bytes);
+    return (static_cast<juce::uint32>(b[0]) << 24) | (static_cast<juce::uint32>(b[1]) << 16)
+         | (static_cast<juce::uint32>(b[2]) << 8) | static_cast<juce::uint32>(b[3]);
+}
+
+bool OSCPacketReader::isBundle(const char* data, int size) noexcept
+{
+    return size >= bundleHeaderSize && std::memcmp(data, "#bundle", 8) == 0;
+}
+
+bool OSCPacketReader::parseMessage(const char* data, int size, Message& message) noexcept
+{
+    if (size < 4 || (size & 3) != 0 || data[0] != '/')
+        return false;
+
+    const int addressSize = paddedStringSize(data, size);
+    if (addressSize < 0)
+        return false;
+
+    message.address = data;
+
+    // 沒有型別標籤的舊式訊息視為沒有參數
+    if (addressSize == size)
+    {
+        message.typeTags = "";
+        message.arguments = data + size;
+        message.argumentsSize = 0;
+        return true;
+    }
+
+    const char* tags = data + addressSize;
+    if (tags[0] != ',')
+        return false;
+
+    const int tagsSize = paddedStringSize(tags, size - addressSize);
+    if (tagsSize < 0)
+        return false;
+
+    message.typeTags = tags + 1;
+    message.arguments = tags + tagsSize;
+    message.argumentsSize = size - addressSize - tagsSize;
+    return true;
+}
+
+//==============================================================================
+int OSCPacketReader::Message::getNumArguments() const noexcept
+{
+    return typeTags != nullptr ? static_cast<int>(std::strlen(typeTags)) : 0;
+}
+
+bool OSCPacketReader::Message::getFloat(int index, float& value) const noexcept
+{
+    if (typeTags == nullptr || index < 0)
+        return false;
+
+    int offset = 0;
+
+    for (int i = 0; typeTags[i] != 0; ++i)
+    {
+        const char tag = typeTags[i];
+        const int available = argumentsSize - offset;
+        const char* argument = arguments + offset;
+
+        int argumentSize = 0;
+        switch (tag)
+        {
+            case 'i': case 'f': case 'c': case 'r': case 'm':
+                argumentSize = 4;
+                break;
+
+            case 'h': case 'd': case 't':
+                argumentSize = 8;
+                break;
+
+            case 's': case 'S':
+                argumentSize = paddedStringSize(argument, available);
+                break;
+
+            case 'b':
+            {
+                if (available < 4)
+                    return false;
+
+                const auto blobSize = static_cast<juce::int64>(readBigEndian32(argument));
+                const auto paddedSize = 4 + ((blobSize + 3) & ~static_cast<juce::int64>(3));
+                argumentSize = paddedSize <= available ? static_cast<int>(paddedSize) : -1;
+                break;
+            }
+
+            case 'T': case 'F': case 'N': case 'I':
+                argumentSize = 0;
+                break;
+
+            default:
+                return false;  // 不認識的型別，無法計算之後參數的位置
+        }
+
+        if (argumentSize < 0 || argumentSize > available)
+            return false;
+
+        if (i == index)
+        {
+            switch (tag)
+            {
+                case 'i':
+                    value = static_cast<float>(static_cast<juce::int32>(readBigEndian32(argument)));
+                    return true;
+
+                case 'f':
+                {
+                    const juce::uint32 bits = readBigEndian32(argument);
+                    std::memcpy(&value, &bits, sizeof(value));
+                    return true;
+                }
+
+                case 'h':
+                    value = static_cast<float>(static_cast<juce::int64>(readBigEndian64(argument)));
+                    return true;
+
+                case 'd':
+                {
+                    const juce::uint64 bits = readBigEndian64(argument);
+                    double d;
+                    std::memcpy(&d, &bits, sizeof(d));
+                    value = static_cast<float>(d);
+                    return true;
+                }
+
+                default:
+                    return false;
+            }
+        }
+
+        offset += argumentSize;
+    }
+
+    return false;
+}
+
+bool OSCPacketReader::Message::addressEndsWith(const char* suffix) const noexcept
+{
+    if (address == nullptr)
+        return false;
+
+    const size_t addressLength = std::strlen(address);
+    const size_t suffixLength = std::strlen(suffix);
+    return addressLength >= suffixLength && std::memcmp(address + addressLength - suffixLength, suffix, suffixLength) == 0;
+}
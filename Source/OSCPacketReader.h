@@ -0,0 +1,86 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+//==============================================================================
+/**
+ * OSC 1.0 封包解碼器（不配置記憶體）
+ * 直接在收到的緩衝區上解析，訊息的地址與型別標籤都指向原始資料。
+ * bundle 會被遞迴展開，對每一個訊息呼叫一次回調。
+ *
+ * 用法：
+ *   OSCPacketReader::forEachMessage (data, size, [] (const OSCPacketReader::Message& m)
+ *   {
+ *       float x, y;
+ *       if (m.getFloat (0, x) && m.getFloat (1, y)) ...
+ *   });
+ */
+class OSCPacketReader
+{
+public:
+    struct Message
+    {
+        const char* address = nullptr;
+        const char* typeTags = nullptr;   // 不含開頭的逗號
+        const char* arguments = nullptr;
+        int argumentsSize = 0;
+
+        int getNumArguments() const noexcept;
+
+        // 把第 index 個數值參數（i/f/h/d）轉成 float；型別不是數值或超出範圍時返回 false
+        bool getFloat(int index, float& value) const noexcept;
+
+        // 地址是否以 suffix 結尾（例如 "/xy"）
+        bool addressEndsWith(const char* suffix) const noexcept;
+    };
+
+    // 解析單一訊息（不是 bundle）；格式錯誤時返回 false
+    static bool parseMessage(const char* data, int size, Message& message) noexcept;
+
+    static bool isBundle(const char* data, int size) noexcept;
+
+    // 對封包中的每一個訊息呼叫 callback(const Message&)；格式錯誤時返回 false
+    template <typename Callback>
+    static bool forEachMessage(const char* data, int size, Callback&& callback, int depth = 0)
+    {
+        if (!isBundle(data, size))
+        {
+            Message message;
+            if (!parseMessage(data, size, message))
+                return false;
+
+            callback(static_cast<const Message&>(message));
+            return true;
+        }
+
+        // 限制巢狀深度，避免惡意封包造成過深的遞迴
+        if (depth >= maxBundleDepth)
+            return false;
+
+        int position = bundleHeaderSize;
+        while (position < size)
+        {
+            if (size - position < 4)
+                return false;
+
+            const int elementSize = static_cast<int>(readBigEndian32(data + position));
+            position += 4;
+
+            if (elementSize <= 0 || (elementSize & 3) != 0 || elementSize > size - position)
+                return false;
+
+            if (!forEachMessage(data + position, elementSize, callback, depth + 1))
+                return false;
+
+            position += elementSize;
+        }
+
+        return true;
+    }
+
+    static juce::uint32 readBigEndian32(const char* bytes) noexcept;
+
+private:
+    static constexpr int bundleHeaderSize = 16;
+    static constexpr int maxBundleDepth = 8;
+};
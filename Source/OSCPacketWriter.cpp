@@ -0,0 +1,84 @@
+#include "OSCPacketWriter.h"
+#include <cstring>
+#include <cmath>
+
+//==============================================================================
+void OSCPacketWriter::writeBytes(const void* bytes, int numBytes) noexcept
+{
+    if (!valid || numBytes > capacity - size)
+    {
+        valid = false;
+        return;
+    }
+
+    std::memcpy(data + size, bytes, static_cast<size_t>(numBytes));
+    size += numBytes;
+}
+
+void OSCPacketWriter::writePaddedString(std::initializer_list<const char*> parts) noexcept
+{
+    int length = 0;
+    for (const char* part : parts)
+    {
+        const int partLength = static_cast<int>(std::strlen(part));
+        writeBytes(part, partLength);
+        length += partLength;
+    }
+
+    // 字串以 '\0' 結尾並補齊到 4 bytes 的倍數
+    static constexpr char zeros[4] = {};
+    writeBytes(zeros, 4 - (length & 3));
+}
+
+void OSCPacketWriter::writeBigEndian32(juce::uint32 value) noexcept
+{
+    const char bytes[4] = { static_cast<char>(value >> 24), static_cast<char>(value >> 16),
+                            static_cast<char>(value >> 8), static_cast<char>(value) };
+    writeBytes(bytes, 4);
+}
+
+//==============================================================================
+void OSCPacketWriter::beginMessage(std::initializer_list<const char*> addressParts, const char* typeTags) noexcept
+{
+    writePaddedString(addressParts);
+    writePaddedString({ ",", typeTags });
+}
+
+void OSCPacketWriter::writeInt32(juce::int32 value) noexcept
+{
+    writeBigEndian32(static_cast<juce::uint32>(value));
+}
+
+void OSCPacketWriter::writeFloat32(float value) noexcept
+{
+    juce::uint32 bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    writeBigEndian32(bits);
+}
+
+//==============================================================================
+void OSCPacketWriter::beginBundle(juce::uint64 timeTag) noexcept
+{
+    writePaddedString({ "#bundle" });
+    writeBigEndian32(static_cast<juce::uint32>(timeTag >> 32));
+    writeBigEndian32(static_cast<juce::uint32>(timeTag));
+}
+
+void OSCPacketWriter::writeBundleElement(const char* elementData, int elementSize) noexcept
+{
+    writeBigEndian32(static_cast<juce::uint32>(elementSize));
+    writeBytes(elementData, elementSize);
+}
+
+juce::uint64 OSCPacketWriter::timeTagFromNow(double secondsFromNow) noexcept
+{
+    // NTP 時間從 1900 年起算，Unix 時間從 1970 年起算
+    constexpr double secondsFrom1900To1970 = 2208988800.0;
+
+    const double seconds = static_cast<double>(juce::Time::currentTimeMillis()) / 1000.0
+                         + secondsFrom1900To1970 + secondsFromNow;
+    const double wholeSeconds = std::floor(seconds);
+    const auto fraction = static_cast<juce::uint64>((seconds - wholeSeconds) * 4294967296.0);
+
+    return (static_cast<juce::uint64>(wholeSeconds) << 32) | (fraction & 0xffffffffULL);
+}
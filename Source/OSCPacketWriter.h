@@ -0,0 +1,59 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <initializer_list>
+
+//==============================================================================
+/**
+ * OSC 1.0 封包編碼器（不配置記憶體）
+ * 直接寫入呼叫者提供的緩衝區，可以在音訊線程中使用。
+ * 超出容量時 isValid() 變為 false，之後的寫入都會被忽略。
+ *
+ * 用法：
+ *   OSCPacketWriter w (buffer, sizeof (buffer));
+ *   w.beginMessage ({ prefix, "/xy" }, "ff");
+ *   w.writeFloat32 (x);
+ *   w.writeFloat32 (y);
+ *
+ * bundle：先 beginBundle (timeTag)，再以 writeBundleElement() 加入已編碼好的訊息。
+ */
+class OSCPacketWriter
+{
+public:
+    OSCPacketWriter(char* destination, int maxSize) noexcept
+        : data(destination), capacity(maxSize) {}
+
+    // 以多個片段組成地址（例如 prefix + "/xy"），並寫入型別標籤（不含開頭的逗號）
+    void beginMessage(std::initializer_list<const char*> addressParts, const char* typeTags) noexcept;
+
+    void writeInt32(juce::int32 value) noexcept;
+    void writeFloat32(float value) noexcept;
+
+    // bundle 標頭（"#bundle" + timetag）與元素（大小 + 內容）
+    void beginBundle(juce::uint64 timeTag) noexcept;
+    void writeBundleElement(const char* elementData, int elementSize) noexcept;
+
+    // 清空內容，重新使用同一個緩衝區
+    void reset() noexcept { size = 0; valid = true; }
+
+    bool isValid() const noexcept { return valid; }
+    int getSize() const noexcept { return valid ? size : 0; }
+    int getCapacity() const noexcept { return capacity; }
+
+    // bundle 標頭的大小（"#bundle\0" + 8 bytes timetag）與每個元素的額外大小
+    static constexpr int bundleHeaderSize = 16;
+    static constexpr int bundleElementOverhead = 4;
+
+    // 以目前的系統時間（加上 secondsFromNow）產生 OSC/NTP timetag
+    static juce::uint64 timeTagFromNow(double secondsFromNow) noexcept;
+
+private:
+    char* data;
+    int capacity;
+    int size = 0;
+    bool valid = true;
+
+    void writeBytes(const void* bytes, int numBytes) noexcept;
+    void writePaddedString(std::initializer_list<const char*> parts) noexcept;
+    void writeBigEndian32(juce::uint32 value) noexcept;
+};
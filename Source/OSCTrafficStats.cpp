@@ -0,0 +1,111 @@
+#include "OSCTrafficStats.h"
+#include <cmath>
+#include <cstring>
+
+//==============================================================================
+void OSCTrafficStats::recordSend(int packetSize, int numMessages, bool isBundle, double latencyMicroseconds) noexcept
+{
+    packets.fetch_add(1, std::memory_order_relaxed);
+    bytes.fetch_add(static_cast<juce::uint64>(packetSize), std::memory_order_relaxed);
+    messages.fetch_add(static_cast<juce::uint64>(numMessages), std::memory_order_relaxed);
+
+    if (isBundle)
+        bundles.fetch_add(1, std::memory_order_relaxed);
+
+    int bucket = 0;
+    for (double limit = 2.0; bucket < numLatencyBuckets - 1 && latencyMicroseconds >= limit; limit *= 2.0)
+        ++bucket;
+
+    latencyCounts[bucket].fetch_add(1, std::memory_order_relaxed);
+}
+
+void OSCTrafficStats::fillSnapshot(Snapshot& snapshot) const noexcept
+{
+    snapshot.timeMs = juce::Time::getMillisecondCounterHiRes();
+    snapshot.packets = packets.load(std::memory_order_relaxed);
+    snapshot.bytes = bytes.load(std::memory_order_relaxed);
+    snapshot.messages = messages.load(std::memory_order_relaxed);
+    snapshot.bundles = bundles.load(std::memory_order_relaxed);
+
+    for (int i = 0; i < numLatencyBuckets; ++i)
+        snapshot.latencyCounts[i] = latencyCounts[i].load(std::memory_order_relaxed);
+}
+
+//==============================================================================
+OSCTrafficStats::Rates OSCTrafficStats::computeRates(const Snapshot& older, const Snapshot& newer) noexcept
+{
+    Rates rates;
+
+    const double seconds = (newer.timeMs - older.timeMs) / 1000.0;
+    if (seconds <= 0.0)
+        return rates;
+
+    // 計數器只會增加；目的地被重新使用時以 0 計算
+    auto perSecond = [seconds](juce::uint64 before, juce::uint64 after)
+    {
+        return after >= before ? static_cast<double>(after - before) / seconds : 0.0;
+    };
+
+    rates.packetsPerSecond = perSecond(older.packets, newer.packets);
+    rates.messagesPerSecond = perSecond(older.messages, newer.messages);
+    rates.bytesPerSecond = perSecond(older.bytes, newer.bytes);
+    rates.bundlesPerSecond = perSecond(older.bundles, newer.bundles);
+    rates.dropsPerSecond = perSecond(older.packetsDropped, newer.packetsDropped);
+
+    juce::uint64 counts[numLatencyBuckets];
+    juce::uint64 total = 0;
+    for (int i = 0; i < numLatencyBuckets; ++i)
+    {
+        counts[i] = newer.latencyCounts[i] >= older.latencyCounts[i] ? newer.latencyCounts[i] - older.latencyCounts[i] : 0;
+        total += counts[i];
+    }
+
+    if (total == 0)
+        return rates;
+
+    auto percentile = [&counts, total](double fraction)
+    {
+        const auto target = static_cast<juce::uint64>(std::ceil(fraction * static_cast<double>(total)));
+        juce::uint64 cumulative = 0;
+
+        for (int i = 0; i < numLatencyBuckets; ++i)
+        {
+            cumulative += counts[i];
+            if (cumulative >= target)
+                return std::ldexp(1.0, i + 1);  // 分段的上限
+        }
+
+        return std::ldexp(1.0, numLatencyBuckets);
+    };
+
+    rates.latencyP50Us = percentile(0.50);
+    rates.latencyP90Us = percentile(0.90);
+    rates.latencyP99Us = percentile(0.99);
+    return rates;
+}
+
+//==============================================================================
+int OSCTrafficStats::countMessages(const char* packetData, int packetSize, bool& isBundle) noexcept
+{
+    isBundle = packetSize >= 16 && std::memcmp(packetData, "#bundle", 8) == 0;
+    if (!isBundle)
+        return 1;
+
+    // bundle 標頭（"#bundle\0" + timetag）之後是「大小 + 內容」的元素
+    int numMessages = 0;
+    int offset = 16;
+
+    while (offset + 4 <= packetSize)
+    {
+        const auto* sizeBytes = reinterpret_cast<const juce::uint8*>(packetData + offset);
+        const int elementSize = static_cast<int>((juce::uint32(sizeBytes[0]) << 24) | (juce::uint32(sizeBytes[1]) << 16)
+                                                 | (juce::uint32(sizeBytes[2]) << 8) | juce::uint32(sizeBytes[3]));
+        if (elementSize <= 0 || elementSize > packetSize - offset - 4)
+            break;
+
+        offset += 4 + elementSize;
+        ++numMessages;
+    }
+
+    return numMessages;
+}
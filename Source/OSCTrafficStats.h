@@ -0,0 +1,62 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <atomic>
+
+//==============================================================================
+/**
+ * 單一目的地的 OSC 流量統計
+ * 發送線程每送出一個封包呼叫一次 recordSend()，只更新 atomic 計數器（不上鎖、不配置記憶體）；
+ * 發送呼叫（socket write）的耗時放入以 2 的次方分段的直方圖（微秒）。
+ *
+ * 任何線程都可以取得 Snapshot，兩個 Snapshot 之間的差就是這段時間的速率與延遲分佈，
+ * 所以不需要由發送線程定期重設計數器。
+ */
+class OSCTrafficStats
+{
+public:
+    // 直方圖分段：第 i 段為 [2^i, 2^(i+1)) 微秒（第 0 段包含小於 1 微秒）
+    static constexpr int numLatencyBuckets = 24;
+
+    // 記錄一個成功送出的封包（發送線程）
+    void recordSend(int packetSize, int numMessages, bool isBundle, double latencyMicroseconds) noexcept;
+
+    struct Snapshot
+    {
+        double timeMs = 0.0;  // juce::Time::getMillisecondCounterHiRes()
+        juce::uint64 packets = 0;
+        juce::uint64 bytes = 0;
+        juce::uint64 messages = 0;
+        juce::uint64 bundles = 0;
+        juce::uint64 packetsDropped = 0;  // 由 OSCDestination 填入
+        int queueDepth = 0;               // 由 OSCDestination 填入
+        juce::uint64 latencyCounts[numLatencyBuckets] = {};
+    };
+
+    void fillSnapshot(Snapshot& snapshot) const noexcept;
+
+    // 兩個快照之間的平均速率與發送延遲的百分位數（分段的上限，微秒）
+    struct Rates
+    {
+        double packetsPerSecond = 0.0;
+        double messagesPerSecond = 0.0;
+        double bytesPerSecond = 0.0;
+        double bundlesPerSecond = 0.0;
+        double dropsPerSecond = 0.0;
+        double latencyP50Us = 0.0;
+        double latencyP90Us = 0.0;
+        double latencyP99Us = 0.0;
+    };
+
+    static Rates computeRates(const Snapshot& older, const Snapshot& newer) noexcept;
+
+    // 封包中的 OSC 訊息數（bundle 的元素數，單一訊息為 1）
+    static int countMessages(const char* packetData, int packetSize, bool& isBundle) noexcept;
+
+private:
+    std::atomic<juce::uint64> packets { 0 };
+    std::atomic<juce::uint64> bytes { 0 };
+    std::atomic<juce::uint64> messages { 0 };
+    std::atomic<juce::uint64> bundles { 0 };
+    std::atomic<juce::uint64> latencyCounts[numLatencyBuckets] {};
+};
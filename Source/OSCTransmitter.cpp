@@ -0,0 +1,248 @@
+#include "OSCTransmitter.h"
+#include "DebugLogger.h"
+
+//==============================================================================
+OSCTransmitter::OSCTransmitter()
+    : juce::Thread("JYPad OSC Sender")
+{
+    // 所有目的地在建構時配置，之後的發送不需要配置記憶體
+    for (int i = 0; i < maxDestinations; ++i)
+    {
+        destinations[i] = std::make_unique<OSCDestination>();
+        destinations[i]->setCaptureWriter(&captureWriter, i);
+        frames[i] = std::make_unique<OSCBundleBuilder>(*destinations[i]);
+    }
+
+    startThread(juce::Thread::Priority::high);
+}
+
+OSCTransmitter::~OSCTransmitter()
+{
+    stopThread(1000);
+}
+
+//==============================================================================
+void OSCTransmitter::setDestinations(const std::vector<OSCDestination::Settings>& settings, bool masterEnabled)
+{
+    const int count = juce::jmin(static_cast<int>(settings.size()), maxDestinations);
+
+    for (int i = 0; i < maxDestinations; ++i)
+    {
+        if (i < count)
+        {
+            const auto& s = settings[static_cast<size_t>(i)];
+            destinations[i]->applySettings(s, masterEnabled && s.enabled);
+
+            DEBUG_LOG("OSCTransmitter: Destination " + juce::String(i + 1) + " " + s.ipAddress + ":" + juce::String(s.port)
+                      + ((masterEnabled && s.enabled) ? " (enabled)" : " (disabled)"));
+        }
+        else
+        {
+            destinations[i]->applySettings({}, false);
+        }
+    }
+
+    numDestinations = count;
+}
+
+bool OSCTransmitter::isEnabled() const noexcept
+{
+    for (int i = 0; i < getNumDestinations(); ++i)
+        if (destinations[i]->isEnabled())
+            return true;
+
+    return false;
+}
+
+bool OSCTransmitter::hasScheduledDestinations() const noexcept
+{
+    for (int i = 0; i < getNumDestinations(); ++i)
+        if (destinations[i]->isEnabled() && destinations[i]->isScheduled())
+            return true;
+
+    return false;
+}
+
+//==============================================================================
+bool OSCTransmitter::sendTo(int index, const char* messageData, int messageSize, bool inFrame) noexcept
+{
+    auto& destination = *destinations[index];
+
+    // 目前線程正在組成 frame：加入同一個 bundle
+    if (inFrame && frames[index]->isOpen())
+        return frames[index]->addMessage(messageData, messageSize);
+
+    if (!destination.isBundleMode())
+        return destination.enqueue(messageData, messageSize);
+
+    // 不屬於任何 tick 的訊息（例如 UI 拖動）：單獨成為一個 bundle
+    OSCBundleBuilder bundle(destination);
+    bundle.begin(OSCPacketWriter::timeTagFromNow(0.0));
+    const bool added = bundle.addMessage(messageData, messageSize);
+    bundle.end();
+    return added;
+}
+
+bool OSCTransmitter::isTargeted(const OSCDestination& destination, bool inFrame) const noexcept
+{
+    if (!destination.isEnabled())
+        return false;
+
+    if (!inFrame)
+        return true;
+
+    switch (frameTarget)
+    {
+        case FrameTarget::liveDestinations:      return !destination.isScheduled();
+        case FrameTarget::scheduledDestinations: return destination.isScheduled();
+        case FrameTarget::allDestinations:       break;
+    }
+
+    return true;
+}
+
+bool OSCTransmitter::send(const char* messageData, int messageSize) noexcept
+{
+    const bool inFrame = (frameThread.load() == juce::Thread::getCurrentThreadId());
+    bool accepted = false;
+
+    for (int i = 0; i < getNumDestinations(); ++i)
+        if (isTargeted(*destinations[i], inFrame))
+            accepted = sendTo(i, messageData, messageSize, inFrame) || accepted;
+
+    return accepted;
+}
+
+bool OSCTransmitter::sendLatest(int key, const char* messageData, int messageSize) noexcept
+{
+    const bool inFrame = (frameThread.load() == juce::Thread::getCurrentThreadId());
+    bool accepted = false;
+
+    for (int i = 0; i < getNumDestinations(); ++i)
+    {
+        auto& destination = *destinations[i];
+        if (!isTargeted(destination, inFrame))
+            continue;
+
+        // 設定了最大頻率：只保存最新值，由發送線程依頻率送出
+        if (destination.storeLatest(key, messageData, messageSize))
+            accepted = true;
+        else
+            accepted = sendTo(i, messageData, messageSize, inFrame) || accepted;
+    }
+
+    return accepted;
+}
+
+void OSCTransmitter::retainLatestKeys(const std::vector<int>& sortedKeys) noexcept
+{
+    // 停用中的目的地也要釋放，重新啟用時才不會留著已刪除的 key
+    for (auto& destination : destinations)
+        destination->retainLatestKeys(sortedKeys);
+}
+
+//==============================================================================
+bool OSCTransmitter::beginFrame(double secondsFromNow, FrameTarget target) noexcept
+{
+    // 同時只能有一個線程擁有 frame
+    juce::Thread::ThreadID expected = nullptr;
+    if (!frameThread.compare_exchange_strong(expected, juce::Thread::getCurrentThreadId()))
+        return false;
+
+    frameTarget = target;
+
+    // timetag 指向這個 tick 在 block 中的時間，接收端可以依此排程
+    const auto timeTag = OSCPacketWriter::timeTagFromNow(secondsFromNow);
+
+    for (int i = 0; i < getNumDestinations(); ++i)
+    {
+        const auto& destination = *destinations[i];
+
+        // 合併模式下位置由發送線程依頻率送出，不需要 frame
+        if (isTargeted(destination, true) && destination.isBundleMode() && !destination.isCoalescing())
+            frames[i]->begin(timeTag);
+    }
+
+    return true;
+}
+
+bool OSCTransmitter::beginBundle() noexcept
+{
+    juce::Thread::ThreadID expected = nullptr;
+    if (!frameThread.compare_exchange_strong(expected, juce::Thread::getCurrentThreadId()))
+        return false;
+
+    frameTarget = FrameTarget::allDestinations;
+
+    for (int i = 0; i < getNumDestinations(); ++i)
+        if (destinations[i]->isEnabled())
+            frames[i]->begin(OSCBundleBuilder::immediateTimeTag);
+
+    return true;
+}
+
+void OSCTransmitter::endFrame() noexcept
+{
+    if (frameThread.load() != juce::Thread::getCurrentThreadId())
+        return;
+
+    // 目的地列表可能在 frame 期間改變，所以檢查所有 frame
+    for (auto& frame : frames)
+        frame->end();
+
+    frameThread = nullptr;
+}
+
+//==============================================================================
+void OSCTransmitter::publishStatsIfDue(double nowMs) noexcept
+{
+    if (nowMs < nextStatsTimeMs)
+        return;
+
+    nextStatsTimeMs = nowMs + statsIntervalMs;
+
+    for (int i = 0; i < maxDestinations; ++i)
+    {
+        auto& destination = *destinations[i];
+
+        // 每次都更新快照，開始發布時的第一個速率只涵蓋最近一秒
+        OSCTrafficStats::Snapshot snapshot;
+        destination.getTrafficSnapshot(snapshot);
+        const auto rates = OSCTrafficStats::computeRates(publishedSnapshots[i], snapshot);
+        const bool hasPrevious = publishedSnapshots[i].timeMs > 0.0;
+        publishedSnapshots[i] = snapshot;
+
+        if (!isPublishingStats() || !hasPrevious || i >= getNumDestinations() || !destination.isEnabled())
+            continue;
+
+        char packet[OSCDestination::maxPacketSize];
+        OSCPacketWriter writer(packet, sizeof(packet));
+        writer.beginMessage({ "/jypad/stats" }, "ffffiff");
+        writer.writeFloat32(static_cast<float>(rates.messagesPerSecond));
+        writer.writeFloat32(static_cast<float>(rates.bytesPerSecond));
+        writer.writeFloat32(static_cast<float>(rates.bundlesPerSecond));
+        writer.writeFloat32(static_cast<float>(rates.dropsPerSecond));
+        writer.writeInt32(snapshot.queueDepth);
+        writer.writeFloat32(static_cast<float>(rates.latencyP50Us));
+        writer.writeFloat32(static_cast<float>(rates.latencyP99Us));
+
+        if (writer.isValid())
+            sendTo(i, packet, writer.getSize(), false);
+    }
+}
+
+void OSCTransmitter::run()
+{
+    while (!threadShouldExit())
+    {
+        // 輪流服務每個目的地，每個目的地每輪最多送出 maxPacketsPerTurn 個封包
+        publishStatsIfDue(juce::Time::getMillisecondCounterHiRes());
+
+        int numServiced = 0;
+        for (auto& destination : destinations)
+            numServiced += destination->service(maxPacketsPerTurn);
+
+        if (numServiced == 0)
+            wait(idleWaitMs);
+    }
+}
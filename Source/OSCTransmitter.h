@@ -0,0 +1,119 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include "OSCDestination.h"
+#include "OSCBundleBuilder.h"
+#include "OSCCaptureWriter.h"
+
+//==============================================================================
+/**
+ * OSC 發送線程
+ * 擁有最多 maxDestinations 個目的地（OSCDestination），每個目的地有自己的佇列、
+ * 輸出格式、最大發送頻率與 socket。送出的訊息會分送（fan-out）到每個啟用的目的地。
+ * 任何線程（UI、音訊線程、回放）都只需要把封包放入佇列，不會因為 socket 而阻塞；
+ * 發送線程輪流服務每個目的地，每輪最多送出固定數量的封包，
+ * 一個目的地積壓或無法連線時不會延遲其他目的地。
+ *
+ * 回放的每個 tick 以 beginFrame() / endFrame() 包起來：bundle 模式的目的地
+ * 會把同一個 tick 的所有訊息合併成一個帶 timetag 的 bundle。
+ * 啟用 lookahead 的目的地（OSCDestination::isScheduled()）只接收提前排程的回放 frame，
+ * 即時的回放 frame 會略過它們；不屬於 frame 的訊息（拖動、mute/solo）仍送到所有目的地。
+ */
+class OSCTransmitter : private juce::Thread
+{
+public:
+    static constexpr int maxDestinations = 4;
+    static constexpr int maxPacketSize = OSCDestination::maxPacketSize;
+
+    // frame 中的訊息要送到哪些目的地
+    enum class FrameTarget
+    {
+        allDestinations,
+        liveDestinations,       // 略過 lookahead 目的地（即時回放）
+        scheduledDestinations   // 只送到 lookahead 目的地（提前排程的回放）
+    };
+
+    OSCTransmitter();
+    ~OSCTransmitter() override;
+
+    // 設定目的地列表（訊息線程）；超出 maxDestinations 的部分被忽略
+    // masterEnabled 為 false 時所有目的地都停用
+    void setDestinations(const std::vector<OSCDestination::Settings>& settings, bool masterEnabled);
+
+    // 是否有任何目的地啟用（任何線程）
+    bool isEnabled() const noexcept;
+
+    // 是否有啟用的 lookahead 目的地（任何線程）
+    bool hasScheduledDestinations() const noexcept;
+
+    int getNumDestinations() const noexcept { return numDestinations.load(std::memory_order_relaxed); }
+    const OSCDestination& getDestination(int index) const noexcept { return *destinations[static_cast<size_t>(index)]; }
+
+    // 一次性的訊息（例如 mute/solo）：分送到每個啟用的目的地（任何線程，不上鎖、不配置記憶體）
+    // 只要有一個目的地接受就返回 true
+    bool send(const char* messageData, int messageSize) noexcept;
+
+    // 連續值（例如球的位置）：設定了最大頻率的目的地只保存每個 key 的最新值，其他目的地直接發送
+    bool sendLatest(int key, const char* messageData, int messageSize) noexcept;
+
+    // 釋放所有目的地中不在 sortedKeys（已排序）裡的 key（訊息線程；球被刪除或載入狀態後）
+    void retainLatestKeys(const std::vector<int>& sortedKeys) noexcept;
+
+    // 回放 tick 的 frame（由同一個線程呼叫）；secondsFromNow 用於計算 bundle 的 timetag
+    // frame 正被其他線程使用時返回 false（之後的訊息不屬於 frame）
+    bool beginFrame(double secondsFromNow, FrameTarget target = FrameTarget::allDestinations) noexcept;
+    void endFrame() noexcept;
+
+    // 一組狀態訊息（例如 mute/solo 的改變）：到 endFrame() 之前 send() 的訊息合併成
+    // 一個立即生效的 bundle，送到每個啟用的目的地（不論輸出格式）
+    // frame 正被其他線程使用時返回 false，訊息照常個別送出
+    bool beginBundle() noexcept;
+
+    // 每秒把每個目的地自己的流量統計以 /jypad/stats 送到該目的地（發送線程）
+    // 參數：messages/s, bytes/s, bundles/s, drops/s (f)、佇列深度 (i)、發送延遲 p50, p99 微秒 (f)
+    void setPublishStats(bool shouldPublish) noexcept { publishStats = shouldPublish; }
+    bool isPublishingStats() const noexcept { return publishStats.load(std::memory_order_relaxed); }
+
+    static constexpr double statsIntervalMs = 1000.0;
+
+    // 把每個送出的封包與時間戳寫入擷取檔（訊息線程開始 / 停止）
+    OSCCaptureWriter& getCaptureWriter() noexcept { return captureWriter; }
+    const OSCCaptureWriter& getCaptureWriter() const noexcept { return captureWriter; }
+
+private:
+    // 宣告在目的地之前，目的地（與發送線程）不再使用後才被解構
+    OSCCaptureWriter captureWriter;
+
+    std::unique_ptr<OSCDestination> destinations[maxDestinations];
+    std::atomic<int> numDestinations { 0 };
+
+    // 每個目的地的 tick frame（只由 frameThread 使用）
+    std::unique_ptr<OSCBundleBuilder> frames[maxDestinations];
+    std::atomic<juce::Thread::ThreadID> frameThread { nullptr };
+    FrameTarget frameTarget = FrameTarget::allDestinations;
+
+    // 統計的發布（只在發送線程中使用）
+    std::atomic<bool> publishStats { false };
+    OSCTrafficStats::Snapshot publishedSnapshots[maxDestinations];
+    double nextStatsTimeMs = 0.0;
+
+    void publishStatsIfDue(double nowMs) noexcept;
+
+    // 每輪服務一個目的地時最多送出的封包數
+    static constexpr int maxPacketsPerTurn = 32;
+
+    // 所有佇列都空的時候發送線程的等待時間
+    static constexpr int idleWaitMs = 1;
+
+    bool sendTo(int index, const char* messageData, int messageSize, bool inFrame) noexcept;
+
+    // 目的地是否接收目前的訊息（frame 之外的訊息送到所有目的地）
+    bool isTargeted(const OSCDestination& destination, bool inFrame) const noexcept;
+
+    void run() override;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(OSCTransmitter)
+};
@@ -0,0 +1,301 @@
+#include "PlaybackEngine.h"
+
+//==============================================================================
+PlaybackEngine::PlaybackEngine(JYPad& pad)
+    : jyPad(pad)
+{
+}
+
+PlaybackEngine::~PlaybackEngine()
+{
+}
+
+//==============================================================================
+void PlaybackEngine::prepare(double sampleRate, int samplesPerBlock)
+{
+    currentSampleRate = sampleRate;
+    currentBlockSize = samplesPerBlock;
+    
+    // 預先配置游標，避免在音訊線程中配置記憶體（新增球超過容量時由訊息線程擴充）
+    reserveForBalls(juce::jmax(minimumBallCapacity, static_cast<size_t>(jyPad.getNumBalls())));
+    reset();
+}
+
+void PlaybackEngine::reserveForBalls(size_t numBalls)
+{
+    if (numBalls <= ballCapacity)
+        return;
+
+    // 加倍成長，逐一新增球時不需要每次重新配置
+    ballCapacity = juce::jmax(numBalls, ballCapacity * 2);
+    cursors.reserve(ballCapacity);
+    evaluatedX.reserve(ballCapacity);
+    evaluatedY.reserve(ballCapacity);
+    hasEvaluated.reserve(ballCapacity);
+    scheduledPositions.reserve(ballCapacity);
+}
+
+void PlaybackEngine::reset()
+{
+    samplePosition = 0;
+    lastUpdateSamplePosition = 0;
+    wasPlaying = false;
+    lastPpqPosition = -1.0;
+    samplesUntilNextTick = 0.0;
+    schedulingAhead = false;
+    nextScheduledTickSample = 0.0;
+    
+    for (auto& c : cursors)
+    {
+        c.cursor.invalidate();
+        c.scheduledCursor.invalidate();
+        c.hasScheduled = false;
+    }
+}
+
+//==============================================================================
+void PlaybackEngine::processBlock(const TransportState& transport, int numSamples)
+{
+    const auto blockStart = samplePosition;
+    samplePosition += numSamples;
+
+    if (!transport.isValid)
+        return;
+
+    // 音訊線程不能等待：如果 UI 正在修改球或錄製數據，這個 block 先跳過，
+    // 下一個 block 會以新的 PPQ 補上
+    const juce::ScopedTryLock lock(jyPad.getStateLock());
+    if (!lock.isLocked())
+    {
+        // 跳過的 block 也要推進 tick 的相位
+        samplesUntilNextTick = juce::jmax(0.0, samplesUntilNextTick - numSamples);
+        return;
+    }
+
+    updateCursorBindings();
+
+    const bool isPlayingChanged = (wasPlaying != transport.isPlaying);
+    wasPlaying = transport.isPlaying;
+
+    const bool wasSchedulingAhead = schedulingAhead;
+    const bool shouldScheduleAhead = transport.isPlaying && transport.canScheduleAhead
+                                  && getLookaheadMs() > 0.0 && onScheduledTick != nullptr;
+
+    if (isPlayingChanged && !transport.isPlaying)
+    {
+        // 從播放變為停止，重置所有球到第一個錄製事件的位置（或中心）
+        schedulingAhead = false;
+        if (onTickBegin)
+            onTickBegin(0.0);
+        jyPad.resetBallsToFirstEventOrCenter();
+        if (onTickEnd)
+            onTickEnd();
+
+        // lookahead 目的地可能還有尚未到時間的排程位置：在排程窗口的結尾再送一次重置後的位置
+        if (wasSchedulingAhead && onScheduledTick != nullptr && currentSampleRate > 0.0)
+            scheduleCurrentPositions(juce::jmax(0.0, nextScheduledTickSample - static_cast<double>(blockStart)) / currentSampleRate);
+
+        lastUpdateSamplePosition = blockStart;
+    }
+    else if (transport.isPlaying)
+    {
+        // 剛開始播放時第一個 tick 落在 block 起點
+        if (isPlayingChanged)
+            samplesUntilNextTick = 0.0;
+
+        if (shouldScheduleAhead)
+            runScheduledTicks(transport, blockStart, numSamples);
+
+        // 即時的 tick 只移動 JYPad 上的球並送到其他目的地
+        schedulingAhead = shouldScheduleAhead;
+        runPlaybackTicks(transport, numSamples);
+        lastUpdateSamplePosition = blockStart;
+    }
+    else if (std::abs(transport.ppqPosition - lastPpqPosition) > 0.001)
+    {
+        // 非播放狀態下 MIDI time 改變（例如使用者移動了播放頭）
+        // 游標會自動退回二分查找
+        evaluateAndApply(transport.ppqPosition, getInterpolationMode(), 0.0);
+        lastUpdateSamplePosition = blockStart;
+    }
+
+    lastPpqPosition = transport.ppqPosition;
+}
+
+//==============================================================================
+void PlaybackEngine::updateCursorBindings()
+{
+    const auto& balls = jyPad.getAllBalls();
+    const auto layoutRevision = jyPad.getLaneLayoutRevision();
+    const bool layoutChanged = (layoutRevision != boundLaneLayoutRevision);
+    boundLaneLayoutRevision = layoutRevision;
+
+    // 在預先配置的容量內調整大小（不配置記憶體），超出容量的球不綁定
+    const size_t numBound = juce::jmin(balls.size(), ballCapacity);
+    if (cursors.size() != numBound)
+        cursors.resize(numBound);
+
+    for (size_t i = 0; i < numBound; ++i)
+    {
+        auto& c = cursors[i];
+        if (layoutChanged || c.ballId != balls[i].id)
+        {
+            c.ballId = balls[i].id;
+            c.lane = jyPad.getLane(c.ballId);
+            c.cursor.invalidate();
+            c.scheduledCursor.invalidate();
+            c.hasScheduled = false;
+        }
+    }
+}
+
+void PlaybackEngine::runPlaybackTicks(const TransportState& transport, int numSamples)
+{
+    const auto mode = getInterpolationMode();
+    const double rateHz = getOutputRateHz();
+
+    if (rateHz <= 0.0 || currentSampleRate <= 0.0)
+    {
+        evaluateAndApply(transport.ppqPosition, mode, 0.0);
+        return;
+    }
+
+    // block 內假設速度固定：PPQ 依 BPM 線性推進
+    const double samplesPerTick = currentSampleRate / rateHz;
+    const double ppqPerSample = transport.bpm / (60.0 * currentSampleRate);
+
+    while (samplesUntilNextTick < numSamples)
+    {
+        evaluateAndApply(transport.ppqPosition + samplesUntilNextTick * ppqPerSample, mode,
+                         samplesUntilNextTick / currentSampleRate);
+        samplesUntilNextTick += samplesPerTick;
+    }
+
+    samplesUntilNextTick -= numSamples;
+}
+
+void PlaybackEngine::evaluateAndApply(double ppqPosition, TrajectoryInterpolator::Mode mode, double secondsFromBlockStart)
+{
+    const auto& balls = jyPad.getAllBalls();
+    const size_t numBalls = cursors.size();
+
+    evaluatedX.resize(numBalls);
+    evaluatedY.resize(numBalls);
+    hasEvaluated.resize(numBalls);
+
+    // 第一步：對所有 lane 求值（只讀取錄製數據，不觸發任何回調）
+    for (size_t i = 0; i < numBalls; ++i)
+    {
+        auto& c = cursors[i];
+
+        // 只在不在 recording 狀態時回放，避免與手動拖動衝突
+        hasEvaluated[i] = 0;
+        if (balls[i].isRecording || c.lane == nullptr)
+            continue;
+
+        const int index = c.cursor.seek(*c.lane, ppqPosition);
+        if (index < 0)
+            continue;
+
+        const auto position = TrajectoryInterpolator::evaluate(*c.lane, index, ppqPosition, mode);
+        evaluatedX[i] = position.x;
+        evaluatedY[i] = position.y;
+        hasEvaluated[i] = 1;
+    }
+
+    // 第二步：套用位置（setBallPosition 只在位置真的改變時才會觸發回調）
+    if (onTickBegin)
+        onTickBegin(secondsFromBlockStart);
+
+    for (size_t i = 0; i < numBalls; ++i)
+        if (hasEvaluated[i] != 0)
+            jyPad.setBallPosition(cursors[i].ballId, evaluatedX[i], evaluatedY[i]);
+
+    if (onTickEnd)
+        onTickEnd();
+}
+
+//==============================================================================
+void PlaybackEngine::runScheduledTicks(const TransportState& transport, juce::int64 blockStart, int numSamples)
+{
+    if (currentSampleRate <= 0.0)
+        return;
+
+    const double ppqPerSample = transport.bpm / (60.0 * currentSampleRate);
+
+    // 剛開始排程，或播放位置跳躍（移動播放頭、loop）：從目前的 block 重新排程
+    // （已經送出的排程無法收回，接收端會在之後收到新的位置）
+    constexpr double jumpTolerancePpq = 0.01;
+    if (!schedulingAhead || std::abs(transport.ppqPosition - expectedPpqPosition) > jumpTolerancePpq)
+    {
+        nextScheduledTickSample = static_cast<double>(blockStart);
+        for (auto& c : cursors)
+            c.hasScheduled = false;
+    }
+
+    expectedPpqPosition = transport.ppqPosition + numSamples * ppqPerSample;
+
+    // 上一個 block 被跳過時，不排程已經過去的 tick
+    nextScheduledTickSample = juce::jmax(nextScheduledTickSample, static_cast<double>(blockStart));
+
+    const double rateHz = getOutputRateHz();
+    const double samplesPerTick = rateHz > 0.0 ? currentSampleRate / rateHz
+                                               : static_cast<double>(juce::jmax(1, currentBlockSize));
+    const double horizon = static_cast<double>(blockStart + numSamples) + getLookaheadMs() * 0.001 * currentSampleRate;
+    const auto mode = getInterpolationMode();
+
+    // 排程窗口內假設速度固定（與 block 內的假設相同）
+    for (int numTicks = 0; nextScheduledTickSample < horizon && numTicks < maxScheduledTicksPerBlock; ++numTicks)
+    {
+        const double samplesFromBlockStart = nextScheduledTickSample - static_cast<double>(blockStart);
+        evaluateAndSchedule(transport.ppqPosition + samplesFromBlockStart * ppqPerSample, mode,
+                            samplesFromBlockStart / currentSampleRate);
+        nextScheduledTickSample += samplesPerTick;
+    }
+}
+
+void PlaybackEngine::evaluateAndSchedule(double ppqPosition, TrajectoryInterpolator::Mode mode, double secondsFromBlockStart)
+{
+    const auto& balls = jyPad.getAllBalls();
+    scheduledPositions.clear();
+
+    for (size_t i = 0; i < cursors.size(); ++i)
+    {
+        auto& c = cursors[i];
+        if (balls[i].isRecording || c.lane == nullptr)
+            continue;
+
+        const int index = c.scheduledCursor.seek(*c.lane, ppqPosition);
+        if (index < 0)
+            continue;
+
+        const auto position = TrajectoryInterpolator::evaluate(*c.lane, index, ppqPosition, mode);
+
+        // 與 JYPad::setBallPosition 相同：只送出真的改變的位置
+        if (c.hasScheduled && std::abs(c.scheduledX - position.x) < 1e-5f && std::abs(c.scheduledY - position.y) < 1e-5f)
+            continue;
+
+        c.hasScheduled = true;
+        c.scheduledX = position.x;
+        c.scheduledY = position.y;
+        scheduledPositions.push_back({ &balls[i], position.x, position.y });
+    }
+
+    if (!scheduledPositions.empty())
+        onScheduledTick(secondsFromBlockStart, scheduledPositions.data(), static_cast<int>(scheduledPositions.size()));
+}
+
+void PlaybackEngine::scheduleCurrentPositions(double secondsFromBlockStart)
+{
+    const auto& balls = jyPad.getAllBalls();
+    scheduledPositions.clear();
+
+    for (size_t i = 0; i < cursors.size(); ++i)
+        scheduledPositions.push_back({ &balls[i], balls[i].x, balls[i].y });
+
+    for (auto& c : cursors)
+        c.hasScheduled = false;
+
+    if (!scheduledPositions.empty())
+        onScheduledTick(secondsFromBlockStart, scheduledPositions.data(), static_cast<int>(scheduledPositions.size()));
+}
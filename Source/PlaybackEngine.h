@@ -0,0 +1,164 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <functional>
+#include "JYPad.h"
+#include "TrajectoryInterpolator.h"
+
+//==============================================================================
+/**
+ * 自動化回放引擎
+ * 由 AudioProcessor 擁有，在 processBlock()（音訊線程）中依照 host 的 PPQ 推進，
+ * 因此即使 Editor 沒有打開也能回放 JYPad 的錄製事件。
+ *
+ * 播放時以設定的輸出頻率（例如 100–1000 Hz）評估位置：每個 tick 依 block 起點的 PPQ
+ * 與 BPM 推算出該 tick 的 PPQ，一次處理所有球（先批次算出位置，再套用），
+ * 位置更新透過 JYPad::setBallPosition() -> onBallMoved 發出。
+ * 輸出頻率為 0 時每個 block 只評估一次。
+ * 每個球有自己的 PlaybackCursor，順向播放時不需要每個 block 重新查找。
+ *
+ * 設定了 lookahead 時，播放中另外把接下來 lookahead 時間內的 tick 提前評估，
+ * 經 onScheduledTick 交給支援 timetag 的目的地，讓接收端在正確的時間套用；
+ * 提前評估不會移動 JYPad 上的球。
+ */
+class PlaybackEngine
+{
+public:
+    // 每個 block 開始時從 playhead 取得的傳輸狀態
+    struct TransportState
+    {
+        bool isValid = false;
+        bool isPlaying = false;
+        double ppqPosition = 0.0;
+        double bpm = 120.0;
+        bool canScheduleAhead = false;  // 是否有目的地接收提前排程的位置
+    };
+
+    explicit PlaybackEngine(JYPad& pad);
+    ~PlaybackEngine();
+
+    void prepare(double sampleRate, int samplesPerBlock);
+    void reset();
+
+    // 依球的數量預先配置游標與評估緩衝（訊息線程，必須持有 JYPad 的 state lock）
+    // 音訊線程不配置記憶體：超出容量的球暫時不回放，直到下一次呼叫
+    void reserveForBalls(size_t numBalls);
+
+    // 在音訊線程中呼叫，numSamples 為本 block 的長度
+    void processBlock(const TransportState& transport, int numSamples);
+
+    // 插值模式與輸出頻率（任何線程都可以設定，下一個 block 生效）
+    void setInterpolationMode(TrajectoryInterpolator::Mode mode) noexcept { interpolationMode = static_cast<int>(mode); }
+    TrajectoryInterpolator::Mode getInterpolationMode() const noexcept { return static_cast<TrajectoryInterpolator::Mode>(interpolationMode.load()); }
+
+    // 每秒評估的次數，0 表示每個 block 一次；限制在 maxOutputRateHz 以內
+    void setOutputRateHz(double rateHz) noexcept { outputRateHz = juce::jlimit(0.0, maxOutputRateHz, rateHz); }
+    double getOutputRateHz() const noexcept { return outputRateHz.load(); }
+
+    static constexpr double maxOutputRateHz = 1000.0;
+
+    // 提前排程的時間（毫秒），0 表示關閉；限制在 maxLookaheadMs 以內
+    void setLookaheadMs(double milliseconds) noexcept { lookaheadMs = juce::jlimit(0.0, maxLookaheadMs, milliseconds); }
+    double getLookaheadMs() const noexcept { return lookaheadMs.load(); }
+
+    static constexpr double maxLookaheadMs = 1000.0;
+
+    // 每個 tick 套用位置前後在音訊線程中呼叫（可以為空）
+    // secondsFromBlockStart 為該 tick 相對於 block 起點的時間，用於把同一個 tick 的 OSC 更新合併成一個 bundle
+    std::function<void(double secondsFromBlockStart)> onTickBegin;
+    std::function<void()> onTickEnd;
+
+    // 提前排程的位置（ball 指向 JYPad 的球，只在回調期間有效）
+    struct ScheduledPosition
+    {
+        const Ball* ball = nullptr;
+        float x = 0.0f;
+        float y = 0.0f;
+    };
+
+    // 每個提前排程的 tick 在音訊線程中呼叫一次（只包含位置改變的球）
+    // secondsFromBlockStart 為該 tick 相對於 block 起點的時間（通常在目前的 block 之後）
+    std::function<void(double secondsFromBlockStart, const ScheduledPosition* positions, int numPositions)> onScheduledTick;
+
+    // 是否正在提前排程（在音訊線程的回調中使用）：此時即時的 tick 不需要送到 lookahead 目的地
+    bool isSchedulingAhead() const noexcept { return schedulingAhead; }
+
+    // 最近一次位置更新所在 block 的起點（以樣本數計，從 prepare() 起算）
+    juce::int64 getLastUpdateSamplePosition() const noexcept { return lastUpdateSamplePosition.load(); }
+
+private:
+    JYPad& jyPad;
+
+    double currentSampleRate = 44100.0;
+    int currentBlockSize = 512;
+
+    // 目前 block 起點的樣本位置（只在音訊線程中使用）
+    juce::int64 samplePosition = 0;
+    std::atomic<juce::int64> lastUpdateSamplePosition { 0 };
+
+    // 預設為 step（與加入插值之前相同），舊的專案載入後聽起來不變
+    std::atomic<int> interpolationMode { static_cast<int>(TrajectoryInterpolator::Mode::step) };
+    std::atomic<double> outputRateHz { 0.0 };
+    std::atomic<double> lookaheadMs { 0.0 };
+
+    // 距離下一個輸出 tick 的樣本數（跨 block 保留，只在音訊線程中使用）
+    double samplesUntilNextTick = 0.0;
+
+    // 提前排程的狀態（只在音訊線程中使用）
+    bool schedulingAhead = false;
+    double nextScheduledTickSample = 0.0;   // 下一個排程 tick 的樣本位置（從 prepare() 起算）
+    double expectedPpqPosition = 0.0;       // 下一個 block 預期的 PPQ，用來偵測跳躍或 loop
+
+    // 每個 block 最多提前評估的 tick 數：剛開始播放時分幾個 block 填滿排程窗口
+    static constexpr int maxScheduledTicksPerBlock = 64;
+
+    // 追蹤之前的播放狀態，用於檢測狀態變化
+    bool wasPlaying = false;
+    double lastPpqPosition = -1.0;
+
+    // 每個球的回放游標（與 JYPad::getAllBalls() 的順序一一對應）
+    struct BallCursor
+    {
+        int ballId = -1;
+        const EventLane* lane = nullptr;
+        PlaybackCursor cursor;
+
+        // 提前排程用的游標與最後排程的位置（只送出改變的位置）
+        PlaybackCursor scheduledCursor;
+        bool hasScheduled = false;
+        float scheduledX = 0.0f;
+        float scheduledY = 0.0f;
+    };
+
+    std::vector<BallCursor> cursors;
+    juce::uint32 boundLaneLayoutRevision = 0;
+
+    // cursors 與評估緩衝已配置的容量（只在持有 state lock 時讀寫）
+    size_t ballCapacity = 0;
+    static constexpr size_t minimumBallCapacity = 256;
+
+    // 球或 lane 佈局改變時重新綁定游標（必須持有 JYPad 的 state lock）
+    void updateCursorBindings();
+
+    // 目前 block 內依輸出頻率產生 tick 並評估
+    void runPlaybackTicks(const TransportState& transport, int numSamples);
+
+    // 在 ppqPosition 評估所有球的位置（先寫入 evaluatedX/Y，再一次套用）
+    void evaluateAndApply(double ppqPosition, TrajectoryInterpolator::Mode mode, double secondsFromBlockStart);
+
+    // 提前評估到 block 結束後 lookahead 時間為止的 tick
+    void runScheduledTicks(const TransportState& transport, juce::int64 blockStart, int numSamples);
+
+    // 在 ppqPosition 評估所有球並交給 onScheduledTick（不移動 JYPad 上的球）
+    void evaluateAndSchedule(double ppqPosition, TrajectoryInterpolator::Mode mode, double secondsFromBlockStart);
+
+    // 停止播放時，在排程窗口結尾送出所有球目前的位置（覆蓋已經排程的位置）
+    void scheduleCurrentPositions(double secondsFromBlockStart);
+
+    // 每次評估的結果（與 cursors 一一對應，預先配置）
+    std::vector<float> evaluatedX, evaluatedY;
+    std::vector<juce::uint8> hasEvaluated;
+    std::vector<ScheduledPosition> scheduledPositions;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PlaybackEngine)
+};
@@ -0,0 +1,64 @@
+#include "PlayheadClock.h"
+#include <cmath>
+
+//==============================================================================
+void PlayheadClock::update(double ppqPosition, double bpm, bool isPlaying, double timeMs) noexcept
+{
+    const juce::uint32 start = sequence.load(std::memory_order_relaxed);
+    sequence.store(start + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    anchorPPQ.store(ppqPosition, std::memory_order_relaxed);
+    anchorTimeMs.store(timeMs, std::memory_order_relaxed);
+    anchorBPM.store(bpm, std::memory_order_relaxed);
+    playing.store(isPlaying && std::isfinite(ppqPosition) && bpm > 0.0, std::memory_order_relaxed);
+
+    sequence.store(start + 2, std::memory_order_release);
+}
+
+void PlayheadClock::invalidate() noexcept
+{
+    const juce::uint32 start = sequence.load(std::memory_order_relaxed);
+    sequence.store(start + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    playing.store(false, std::memory_order_relaxed);
+
+    sequence.store(start + 2, std::memory_order_release);
+}
+
+bool PlayheadClock::getPPQAt(double timeMs, double& ppqPosition) const noexcept
+{
+    double ppq = 0.0, anchorMs = 0.0, bpm = 0.0;
+    bool isPlaying = false;
+
+    // 寫入者每個 block 只更新一次，重試幾次一定能讀到一致的數值
+    for (int attempt = 0;; ++attempt)
+    {
+        const juce::uint32 before = sequence.load(std::memory_order_acquire);
+
+        ppq = anchorPPQ.load(std::memory_order_relaxed);
+        anchorMs = anchorTimeMs.load(std::memory_order_relaxed);
+        bpm = anchorBPM.load(std::memory_order_relaxed);
+        isPlaying = playing.load(std::memory_order_relaxed);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        if ((before & 1) == 0 && sequence.load(std::memory_order_relaxed) == before)
+            break;
+
+        if (attempt >= 16)
+            return false;
+    }
+
+    if (!isPlaying)
+        return false;
+
+    // 封包可能比 block 開始的時間稍早到達（兩個線程的時間差），負值同樣外插
+    const double elapsedMs = timeMs - anchorMs;
+    if (std::abs(elapsedMs) > maxExtrapolationMs)
+        return false;
+
+    ppqPosition = ppq + (elapsedMs / 60000.0) * bpm;
+    return true;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <atomic>
+
+//==============================================================================
+/**
+ * 主機播放位置的時鐘
+ * 音訊線程在每個 block 開始時記錄「這個時刻的 PPQ 與 BPM」；
+ * 其他線程（例如 OSC 輸入線程）可以用任意時刻推算出當時的 PPQ，
+ * 不需要等到下一個 block，所以高頻率的外部資料也有各自的時間位置。
+ *
+ * update() 只能由單一線程（音訊線程）呼叫；getPPQAt() 可以從任何線程呼叫（不上鎖）。
+ */
+class PlayheadClock
+{
+public:
+    PlayheadClock() = default;
+
+    // 記錄 block 開始時的播放位置；timeMs 為 juce::Time::getMillisecondCounterHiRes()
+    void update(double ppqPosition, double bpm, bool isPlaying, double timeMs) noexcept;
+
+    // 停止播放或主機沒有呼叫 processBlock 時
+    void invalidate() noexcept;
+
+    // 推算 timeMs 時刻的 PPQ；沒有在播放，或距離上一個 block 太久時返回 false
+    bool getPPQAt(double timeMs, double& ppqPosition) const noexcept;
+
+    // 超過這個時間沒有新的 block 就不再外插（主機暫停處理或離線渲染）
+    static constexpr double maxExtrapolationMs = 500.0;
+
+private:
+    // seqlock：寫入時序號為奇數，讀取者看到序號改變就重讀
+    std::atomic<juce::uint32> sequence { 0 };
+    std::atomic<double> anchorPPQ { 0.0 };
+    std::atomic<double> anchorTimeMs { 0.0 };
+    std::atomic<double> anchorBPM { 120.0 };
+    std::atomic<bool> playing { false };
+
+    JUCE_DECLARE_NON_COPYABLE(PlayheadClock)
+};
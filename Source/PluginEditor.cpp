@@ -6,7 +6,8 @@
 PlugDataCustomObjectAudioProcessorEditor::PlugDataCustomObjectAudioProcessorEditor (PlugDataCustomObjectAudioProcessor& p)
     : AudioProcessorEditor (&p), 
       audioProcessor (p),
-      jyPadEditor (p.jyPad, p)
+      jyPadEditor (p.jyPad, p),
+      oscLogView (p)
 {
     DEBUG_LOG("PluginEditor: Constructor started - STEP 1");
     
@@ -67,43 +68,10 @@ PlugDataCustomObjectAudioProcessorEditor::PlugDataCustomObjectAudioProcessorEdit
     addAndMakeVisible (&outputLabel);
     DEBUG_LOG("PluginEditor: outputLabel added - STEP 12");
     
-    // 設定輸出文字區域
-    DEBUG_LOG("PluginEditor: Setting up outputText - STEP 13");
-    outputText.setMultiLine (true);
-    outputText.setReadOnly (true);
-    outputText.setFont (juce::Font(juce::FontOptions().withHeight(12.0f)));
-    outputText.setScrollbarsShown(true);
-    outputText.setColour (juce::TextEditor::backgroundColourId, juce::Colour (0xff2a2a2a));
-    outputText.setColour (juce::TextEditor::textColourId, juce::Colours::white);
-    addAndMakeVisible (&outputText);
-    DEBUG_LOG("PluginEditor: outputText added - STEP 14");
-    
-    // 設定 JYPad 的回調，當球移動時發送 OSC（OSC 訊息會自動記錄到訊息視窗）
-    DEBUG_LOG("PluginEditor: Setting up JYPad callback - STEP 15");
-    audioProcessor.jyPad.onBallMoved = [this](int ballId, float x, float y) {
-        // 座標乘以 10 用於顯示和輸出
-        float outputX = x * 10.0f;
-        float outputY = y * 10.0f;
-        
-        // 發送 OSC 訊息（使用乘以 10 後的座標，訊息會自動記錄到訊息視窗）
-        if (audioProcessor.oscSettings.enabled)
-        {
-            audioProcessor.sendOSCMessage(ballId, outputX, outputY);
-        }
-
-        // Restore UI Update: Manually trigger repaint since we overwrote the original callback
-        // This ensures the ball moves visually during automation/replay.
-        if (juce::MessageManager::getInstance()->isThisTheMessageThread())
-        {
-            jyPadEditor.updateDisplay();
-        }
-        else
-        {
-            juce::MessageManager::callAsync([this]() {
-                jyPadEditor.updateDisplay();
-            });
-        }
-    };
+    // 設定 OSC 訊息記錄
+    DEBUG_LOG("PluginEditor: Setting up oscLogView - STEP 13");
+    addAndMakeVisible (&oscLogView);
+    DEBUG_LOG("PluginEditor: oscLogView added - STEP 14");
     
     // OSC Data 視窗按鈕（暫時隱藏）
     DEBUG_LOG("PluginEditor: Setting up OSC Data button - STEP 17");
@@ -177,6 +145,7 @@ PlugDataCustomObjectAudioProcessorEditor::~PlugDataCustomObjectAudioProcessorEdi
     try
     {
         stopTimer();
+        audioProcessor.setEditor(nullptr);
         openOSCDataButton.setLookAndFeel(nullptr);
         openNetworkSettingsButton.setLookAndFeel(nullptr);
         
@@ -274,11 +243,11 @@ void PlugDataCustomObjectAudioProcessorEditor::resized()
     
     area.removeFromTop(20);  // 間距
     
-    // 輸出標籤和文字區域（OSC Message Window 只顯示 4 行）
+    // 輸出標籤和 OSC 訊息記錄（工具列 + 約 4 行）
     outputLabel.setBounds(area.removeFromTop(25));
     area.removeFromTop(5);
-    // 字體大小 12.0f，每行約 14.4px（含行間距），4 行約 60px
-    outputText.setBounds(area.removeFromTop(60));
+    // 工具列 22px + 間距 4px，每行 14px，4 行約 60px
+    oscLogView.setBounds(area.removeFromTop(86));
 }
 
 //==============================================================================
@@ -287,69 +256,13 @@ void PlugDataCustomObjectAudioProcessorEditor::timerCallback()
     // 更新時間碼顯示
     auto timeInfo = audioProcessor.getTimeCodeInfo();
     
+    // 回放由 Processor 的 PlaybackEngine 在 processBlock 中處理，
+    // 這裡只在球的位置改變過時重繪
+    if (audioProcessor.consumeBallPositionsChanged())
+        jyPadEditor.updateDisplay();
+    
     if (timeInfo.isValid)
     {
-        // 檢測播放狀態變化：從播放變為停止
-        bool isPlayingChanged = (wasPlaying != timeInfo.isPlaying);
-        wasPlaying = timeInfo.isPlaying;
-        
-        // 如果從播放變為停止，重置所有球到第一個錄製事件的位置
-        if (isPlayingChanged && !timeInfo.isPlaying)
-        {
-            // Optimization: Only repaint if necessary, let setBallPosition handle individual changes
-            // But we might need one global repaint if multiple things change at once, 
-            // however, setBallPosition now sends callbacks.
-            // For batch updates like this, individual callbacks might cause multiple repaints.
-            // A better approach in JYPad would be a "batch update" mode, but for now relying on the callback is fine
-            // provided the callback logic isn't too heavy.
-            // Actually, setBallPosition touches the model. The VIEW listens to it.
-            
-            for (const auto& ball : audioProcessor.jyPad.getAllBalls())
-            {
-                const RecordedEvent* firstEvent = audioProcessor.jyPad.getFirstEvent(ball.id);
-                if (firstEvent != nullptr)
-                {
-                    // 有錄製數據，重置到第一個事件的位置
-                    audioProcessor.jyPad.setBallPosition(ball.id, firstEvent->x, firstEvent->y);
-                }
-                else
-                {
-                    // 沒有錄製數據，重置到中心 (0, 0)
-                    audioProcessor.jyPad.setBallPosition(ball.id, 0.0f, 0.0f);
-                }
-            }
-            // Removing explicit repaint here because setBallPosition will trigger it via callback if needed
-        }
-        
-        // 當不在播放狀態時，如果 MIDI time 改變，更新球的位置到該時間點之前最後一個事件
-        if (!timeInfo.isPlaying && timeInfo.isValid)
-        {
-            if (std::abs(timeInfo.ppqPosition - lastMidiTime) > 0.001)  // MIDI time 改變了
-            {
-                // 遍歷所有球，更新它們的位置
-                const auto& balls = audioProcessor.jyPad.getAllBalls();
-                for (const auto& ball : balls)
-                {
-                    if (!ball.isRecording)  // 只在非錄製狀態下更新
-                    {
-                        const auto* event = audioProcessor.jyPad.getLastEventBeforeTime(ball.id, timeInfo.ppqPosition);
-                        if (event != nullptr)
-                        {
-                            // 更新球的位置到該事件的位置
-                            audioProcessor.jyPad.setBallPosition(ball.id, event->x, event->y);
-                        }
-                    }
-                }
-                // Removing explicit repaint here
-            }
-            lastMidiTime = timeInfo.ppqPosition;
-        }
-        else if (timeInfo.isPlaying)
-        {
-            // 播放狀態下也更新 lastMidiTime，以便在停止時能正確檢測變化
-            lastMidiTime = timeInfo.ppqPosition;
-        }
-        
         // Optimization: Only update text if changed
         juce::String midiTimeStr = formatMIDITime(timeInfo.ppqPosition, timeInfo.bpm);
         if (midiTimeLabel.getText() != midiTimeStr)
@@ -386,7 +299,6 @@ void PlugDataCustomObjectAudioProcessorEditor::timerCallback()
         
         bool needsBlinkRepaint = false;
         
-        // 檢查所有球是否需要回放錄製的事件（只在播放狀態時回放）
         if (timeInfo.isPlaying)
         {
             for (const auto& ball : audioProcessor.jyPad.getAllBalls())
@@ -394,24 +306,13 @@ void PlugDataCustomObjectAudioProcessorEditor::timerCallback()
                 if (ball.isRecording)
                 {
                     needsBlinkRepaint = true;
-                }
-                
-                // 檢查是否有錄製的事件需要回放（只在不在 recording 狀態時回放，避免與手動拖動衝突）
-                if (!ball.isRecording)  // 只在不在 recording 狀態時回放
-                {
-                    const RecordedEvent* event = audioProcessor.jyPad.getEventAtTime(ball.id, timeInfo.ppqPosition);
-                    if (event != nullptr)
-                    {
-                        // 更新球的位置（只在位置改變時更新，節省資源）
-                        // This uses the new epsilon check inside setBallPosition
-                        audioProcessor.jyPad.setBallPosition(ball.id, event->x, event->y);
-                    }
+                    break;
                 }
             }
         }
         
         // Only repaint if we are recording (for blink animation)
-        // Regular movement is handled by setBallPosition callback.
+        // Regular movement is handled by consumeBallPositionsChanged() above.
         if (needsBlinkRepaint)
         {
             jyPadEditor.repaint();
@@ -510,34 +411,3 @@ juce::String PlugDataCustomObjectAudioProcessorEditor::formatBPMInfo(double bpm,
     
     return info;
 }
-
-//==============================================================================
-void PlugDataCustomObjectAudioProcessorEditor::logOSCMessage(const juce::String& message)
-{
-    // 在訊息線程中更新 OSC 訊息視窗
-    if (juce::MessageManager::getInstance()->isThisTheMessageThread())
-    {
-        // 優化：限制訊息長度，避免過長的字符串操作
-        juce::String msg = message.substring(0, 100); 
-        
-        // 優化：直接追加文本，而不是重新構建整個字符串
-        outputText.moveCaretToEnd();
-        outputText.insertTextAtCaret(msg + "\n");
-        
-        // 限制總行數（簡單檢查長度，避免重讀全部內容）
-        if (outputText.getText().length() > 20000)
-        {
-            juce::String currentText = outputText.getText();
-            // 只保留後面的部分
-             outputText.setText(currentText.substring(currentText.length() - 10000), juce::dontSendNotification);
-             outputText.moveCaretToEnd();
-        }
-    }
-    else
-    {
-        // 如果不在訊息線程中，使用異步更新
-        juce::MessageManager::callAsync([this, message]() {
-            logOSCMessage(message);
-        });
-    }
-}
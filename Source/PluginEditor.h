@@ -6,6 +6,7 @@
 #include "JYPadEditor.h"
 #include "OSCDataWindow.h"
 #include "NetworkSettingsWindow.h"
+#include "OSCLogView.h"
 
 //==============================================================================
 /**
@@ -27,20 +28,6 @@ public:
     // 當視窗可見性改變時，同步關閉子視窗
     void visibilityChanged() override;
     
-    // 記錄 OSC 訊息到訊息視窗（公開方法，供 Processor 調用）
-    void logOSCMessage(const juce::String& message);
-    
-public:
-    // 記錄 OSC 訊息到訊息視窗（供 Processor 調用）
-
-private:
-    // 追蹤之前的播放狀態，用於檢測狀態變化
-    bool wasPlaying = false;
-    double lastMidiTime = -1.0;  // 追蹤上一次的 MIDI time
-
-public:
-    // 記錄 OSC 訊息到訊息視窗（供 Processor 調用）
-
 private:
     // This reference is provided as a quick way for your editor to
     // access the processor object that created it.
@@ -56,7 +43,7 @@ private:
     
     // 輸出顯示區域
     juce::Label outputLabel;
-    juce::TextEditor outputText;
+    OSCLogView oscLogView;  // 送出的 OSC 訊息（虛擬化列表，可暫停與篩選）
     
     // OSC Data 視窗按鈕
     juce::TextButton openOSCDataButton;
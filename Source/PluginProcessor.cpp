@@ -1,6 +1,7 @@
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
 #include "DebugLogger.h"
+#include "OSCPacketWriter.h"
 
 //==============================================================================
 PlugDataCustomObjectAudioProcessor::PlugDataCustomObjectAudioProcessor()
@@ -21,6 +22,44 @@ PlugDataCustomObjectAudioProcessor::PlugDataCustomObjectAudioProcessor()
     {
         DEBUG_LOG("PluginProcessor: Initializing JYPad");
         // JYPad 會在構造函數中自動初始化
+        // 球移動的回調由 Processor 持有，這樣 Editor 關閉時回放仍會發送 OSC
+        jyPad.onBallMoved = [this](int ballId, float x, float y) {
+            handleBallMoved(ballId, x, y);
+        };
+        
+        // 來源改變時重建 OSC 輸入的路由表
+        // 同時在訊息線程擴充回放游標，音訊線程不需要配置記憶體（回調時已持有 state lock）
+        jyPad.onBallLayoutChanged = [this] {
+            playbackEngine.reserveForBalls(static_cast<size_t>(jyPad.getNumBalls()));
+            rebuildOSCInputRoutes();
+            releaseRemovedOSCKeys();
+        };
+        rebuildOSCInputRoutes();
+        
+        // 錄製 OSC 輸入：以封包到達時推算的 PPQ 記錄（在 OSC 輸入線程中，唯一的 oscInput 生產者）
+        oscInput.onRecordPosition = [this](int ballId, float x, float y, double timeMs) {
+            double ppqPosition = 0.0;
+            if (playheadClock.getPPQAt(timeMs, ppqPosition))
+                jyPad.captureEvent(CaptureProducer::oscInput, ballId, ppqPosition,
+                                   juce::jlimit(-1.0f, 1.0f, x / 10.0f),
+                                   juce::jlimit(-1.0f, 1.0f, y / 10.0f));
+        };
+        
+        // 回放的每個 tick 是一個 OSC frame（bundle 模式下合併成一個 bundle）
+        // 提前排程時，即時的 tick 只送到沒有啟用 lookahead 的目的地
+        playbackEngine.onTickBegin = [this](double secondsFromBlockStart) {
+            oscTransmitter.beginFrame(secondsFromBlockStart, playbackEngine.isSchedulingAhead()
+                                                                ? OSCTransmitter::FrameTarget::liveDestinations
+                                                                : OSCTransmitter::FrameTarget::allDestinations);
+        };
+        playbackEngine.onTickEnd = [this] {
+            oscTransmitter.endFrame();
+        };
+        
+        // 提前排程的 tick：以 timetag 送到 lookahead 目的地（不移動 JYPad 上的球，也不寫入 OSC 紀錄）
+        playbackEngine.onScheduledTick = [this](double secondsFromBlockStart, const PlaybackEngine::ScheduledPosition* positions, int numPositions) {
+            sendScheduledPositions(secondsFromBlockStart, positions, numPositions);
+        };
         
         DEBUG_LOG("PluginProcessor: Initializing DataTable");
         // DataTable 會在構造函數中自動初始化
@@ -45,6 +84,19 @@ PlugDataCustomObjectAudioProcessor::PlugDataCustomObjectAudioProcessor()
 
 PlugDataCustomObjectAudioProcessor::~PlugDataCustomObjectAudioProcessor()
 {
+    jyPad.onBallMoved = nullptr;
+    jyPad.onBallLayoutChanged = nullptr;
+    playbackEngine.onTickBegin = nullptr;
+    playbackEngine.onTickEnd = nullptr;
+    playbackEngine.onScheduledTick = nullptr;
+    backgroundJobs.removeAllJobs(true, 2000);
+}
+
+//==============================================================================
+void PlugDataCustomObjectAudioProcessor::simplifyRecordingsAsync(std::vector<int> ballIds, float tolerance,
+    std::function<void(const TrajectorySimplifier::Result&)> onComplete)
+{
+    backgroundJobs.addJob(new TrajectorySimplifier::Job(jyPad, std::move(ballIds), tolerance, std::move(onComplete)), true);
 }
 
 //==============================================================================
@@ -114,6 +166,7 @@ void PlugDataCustomObjectAudioProcessor::prepareToPlay (double sampleRate, int s
 {
     // 初始化 JYPad
     jyPad.prepare(sampleRate, samplesPerBlock);
+    playbackEngine.prepare(sampleRate, samplesPerBlock);
 }
 
 void PlugDataCustomObjectAudioProcessor::releaseResources()
@@ -158,10 +211,14 @@ void PlugDataCustomObjectAudioProcessor::processBlock (juce::AudioBuffer<float>&
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear (i, 0, buffer.getNumSamples());
 
+    // 這個 block 開始的時間（OSC 輸入的重新取樣與錄製時間都以此為基準）
+    const double blockStartTimeMs = juce::Time::getMillisecondCounterHiRes();
+    
     // 在 processBlock 中獲取時間碼資訊（只能在這裡調用 getPlayHead）
     {
         // juce::ScopedLock lock(timeCodeLock); // Removed, using atomics
         
+        bool clockUpdated = false;
         auto* playHead = getPlayHead();
         if (playHead != nullptr)
         {
@@ -176,10 +233,31 @@ void PlugDataCustomObjectAudioProcessor::processBlock (juce::AudioBuffer<float>&
                 cachedTimeCodeInfo.timeSignatureDenominator = positionInfo.timeSigDenominator;
                 cachedTimeCodeInfo.ppqPositionOfLastBarStart = positionInfo.ppqPositionOfLastBarStart;
                 cachedTimeCodeInfo.isValid = true;
+                
+                playheadClock.update(positionInfo.ppqPosition, positionInfo.bpm, positionInfo.isPlaying, blockStartTimeMs);
+                clockUpdated = true;
             }
         }
+        
+        if (!clockUpdated)
+            playheadClock.invalidate();
     }
 
+    // 套用 OSC 輸入的位置（在回放之前，讓同一個 block 的輸出包含最新的遠端位置）
+    applyOSCInput(blockStartTimeMs);
+    
+    // 推進自動化回放（依照 playhead 的 PPQ，每個 block 評估一次）
+    PlaybackEngine::TransportState transport;
+    transport.isValid = cachedTimeCodeInfo.isValid.load();
+    transport.isPlaying = cachedTimeCodeInfo.isPlaying.load();
+    transport.ppqPosition = cachedTimeCodeInfo.ppqPosition.load();
+    transport.bpm = cachedTimeCodeInfo.bpm.load();
+    transport.canScheduleAhead = oscTransmitter.hasScheduledDestinations();
+    playbackEngine.processBlock(transport, buffer.getNumSamples());
+    
+    // 在回放之後重送一部分球的位置，讓刷新內容是這個 block 的最新位置
+    refreshOSCState(buffer.getNumSamples());
+
     // 處理音訊（JYPad 主要用於控制，但保留音訊處理能力）
     jyPad.processBlock(buffer, midiMessages);
 }
@@ -225,16 +303,59 @@ void PlugDataCustomObjectAudioProcessor::getStateInformation (juce::MemoryBlock&
     // 保存數據表格狀態
     dataTable.saveState(mos);
     
-    // 保存 OSC 設置
+    // 保存 OSC 設置（第一個目的地的地址保留在舊的位置，讓舊版本也能讀取）
+    OSCSettings settings;
     {
         juce::ScopedLock lock(oscSettingsLock);
-        mos.writeString(oscSettings.ipAddress);
-        mos.writeInt(oscSettings.port);
-        mos.writeBool(oscSettings.enabled);
+        settings = oscSettings;
     }
+    const auto firstDestination = settings.destinations.empty() ? OSCDestination::Settings() : settings.destinations.front();
+    mos.writeString(firstDestination.ipAddress);
+    mos.writeInt(firstDestination.port);
+    mos.writeBool(settings.enabled);
     
     // 保存 zoom scale
     mos.writeFloat(zoomScale);
+    
+    // 保存回放設置（插值模式、輸出頻率）
+    mos.writeInt(static_cast<int>(playbackEngine.getInterpolationMode()));
+    mos.writeDouble(playbackEngine.getOutputRateHz());
+    
+    // 保存第一個目的地的 bundle 模式與最大發送頻率
+    mos.writeBool(firstDestination.bundleMode);
+    mos.writeDouble(firstDestination.maxRateHz);
+    
+    // 保存完整的目的地列表
+    mos.writeInt(static_cast<int>(settings.destinations.size()));
+    for (const auto& destination : settings.destinations)
+    {
+        mos.writeString(destination.ipAddress);
+        mos.writeInt(destination.port);
+        mos.writeBool(destination.enabled);
+        mos.writeBool(destination.bundleMode);
+        mos.writeDouble(destination.maxRateHz);
+    }
+    
+    // 保存 OSC 輸入設置
+    mos.writeBool(settings.inputEnabled);
+    mos.writeInt(settings.inputPort);
+    
+    // 保存 lookahead 設置（時間與每個目的地是否啟用）
+    mos.writeDouble(playbackEngine.getLookaheadMs());
+    mos.writeInt(static_cast<int>(settings.destinations.size()));
+    for (const auto& destination : settings.destinations)
+        mos.writeBool(destination.lookahead);
+    
+    // 保存完整狀態的刷新頻率
+    mos.writeDouble(settings.refreshRateHz);
+    
+    // 保存每個目的地重新連線期間的處理方式
+    mos.writeInt(static_cast<int>(settings.destinations.size()));
+    for (const auto& destination : settings.destinations)
+        mos.writeBool(destination.holdWhileReconnecting);
+    
+    // 保存是否發布流量統計
+    mos.writeBool(settings.publishStats);
 }
 
 void PlugDataCustomObjectAudioProcessor::setStateInformation (const void* data, int sizeInBytes)
@@ -247,7 +368,20 @@ void PlugDataCustomObjectAudioProcessor::setStateInformation (const void* data,
         
         DEBUG_LOG("PluginProcessor: Loading JYPad state");
         // 載入 JYPad 狀態
-        jyPad.loadState(mis);
+        if (!jyPad.loadState(mis))
+        {
+            // 之後的數據位置無法確定：不再解析，其餘設定與沒有這些欄位的舊狀態一樣使用預設值
+            DEBUG_LOG_ERROR("PluginProcessor: JYPad state is corrupt, ignoring the rest of the state");
+            mis.setPosition(mis.getDataSize());
+        }
+        
+        // loadState 直接重建球列表，不會觸發 onBallLayoutChanged
+        {
+            const juce::ScopedLock lock(jyPad.getStateLock());
+            playbackEngine.reserveForBalls(static_cast<size_t>(jyPad.getNumBalls()));
+        }
+        rebuildOSCInputRoutes();
+        releaseRemovedOSCKeys();
         DEBUG_LOG("PluginProcessor: JYPad state loaded");
         
         DEBUG_LOG("PluginProcessor: Loading DataTable state");
@@ -261,8 +395,9 @@ void PlugDataCustomObjectAudioProcessor::setStateInformation (const void* data,
             DEBUG_LOG("PluginProcessor: Loading OSC settings");
             {
                 juce::ScopedLock lock(oscSettingsLock);
-                oscSettings.ipAddress = mis.readString();
-                oscSettings.port = mis.readInt();
+                oscSettings.destinations.assign(1, OSCDestination::Settings());
+                oscSettings.destinations[0].ipAddress = mis.readString();
+                oscSettings.destinations[0].port = mis.readInt();
                 oscSettings.enabled = mis.readBool();
             }
             updateOSCConnection();
@@ -287,6 +422,163 @@ void PlugDataCustomObjectAudioProcessor::setStateInformation (const void* data,
             DEBUG_LOG("PluginProcessor: No zoom scale in state, using default");
         }
         
+        // 載入回放設置（如果存在）
+        if (!mis.isExhausted())
+        {
+            int mode = mis.readInt();
+            if (mode >= 0 && mode < static_cast<int>(TrajectoryInterpolator::Mode::numModes))
+                playbackEngine.setInterpolationMode(static_cast<TrajectoryInterpolator::Mode>(mode));
+            
+            if (!mis.isExhausted())
+            {
+                double rateHz = mis.readDouble();
+                if (std::isfinite(rateHz))
+                    playbackEngine.setOutputRateHz(rateHz);
+            }
+            DEBUG_LOG("PluginProcessor: Playback settings loaded");
+        }
+        else
+        {
+            // 舊版本的狀態沒有插值模式：維持原本的 step 行為
+            playbackEngine.setInterpolationMode(TrajectoryInterpolator::Mode::step);
+            playbackEngine.setOutputRateHz(0.0);
+            DEBUG_LOG("PluginProcessor: No playback settings in state, using defaults");
+        }
+        
+        // 載入 OSC bundle 模式（如果存在）
+        if (!mis.isExhausted())
+        {
+            {
+                juce::ScopedLock lock(oscSettingsLock);
+                oscSettings.destinations[0].bundleMode = mis.readBool();
+                
+                if (!mis.isExhausted())
+                {
+                    double rateHz = mis.readDouble();
+                    oscSettings.destinations[0].maxRateHz = std::isfinite(rateHz) ? juce::jlimit(0.0, OSCDestination::maxAllowedRateHz, rateHz) : 0.0;
+                }
+            }
+            updateOSCConnection();
+            DEBUG_LOG("PluginProcessor: OSC bundle mode and rate loaded");
+        }
+        
+        // 載入目的地列表（如果存在）
+        if (!mis.isExhausted())
+        {
+            const int numDestinations = mis.readInt();
+            
+            // 每個目的地至少 15 bytes（空字串 + port + 兩個 bool + double）
+            if (numDestinations < 1 || numDestinations > OSCTransmitter::maxDestinations
+                || numDestinations * 15 > mis.getNumBytesRemaining())
+            {
+                DEBUG_LOG_ERROR("PluginProcessor: Invalid OSC destination count: " + juce::String(numDestinations));
+            }
+            else
+            {
+                std::vector<OSCDestination::Settings> destinations(static_cast<size_t>(numDestinations));
+                for (auto& destination : destinations)
+                {
+                    destination.ipAddress = mis.readString();
+                    destination.port = mis.readInt();
+                    destination.enabled = mis.readBool();
+                    destination.bundleMode = mis.readBool();
+                    const double rateHz = mis.readDouble();
+                    destination.maxRateHz = std::isfinite(rateHz) ? juce::jlimit(0.0, OSCDestination::maxAllowedRateHz, rateHz) : 0.0;
+                }
+                
+                juce::ScopedLock lock(oscSettingsLock);
+                oscSettings.destinations = std::move(destinations);
+            }
+            updateOSCConnection();
+            DEBUG_LOG("PluginProcessor: OSC destinations loaded");
+        }
+        
+        // 載入 OSC 輸入設置（如果存在）
+        if (!mis.isExhausted())
+        {
+            {
+                juce::ScopedLock lock(oscSettingsLock);
+                oscSettings.inputEnabled = mis.readBool();
+                
+                const int inputPort = mis.readInt();
+                if (inputPort > 0 && inputPort < 65536)
+                    oscSettings.inputPort = inputPort;
+            }
+            updateOSCConnection();
+            DEBUG_LOG("PluginProcessor: OSC input settings loaded");
+        }
+        
+        // 載入 lookahead 設置（如果存在）
+        if (!mis.isExhausted())
+        {
+            const double lookaheadMs = mis.readDouble();
+            if (std::isfinite(lookaheadMs))
+                playbackEngine.setLookaheadMs(lookaheadMs);
+            
+            if (!mis.isExhausted())
+            {
+                const int numDestinations = mis.readInt();
+                
+                juce::ScopedLock lock(oscSettingsLock);
+                if (numDestinations == static_cast<int>(oscSettings.destinations.size())
+                    && numDestinations <= mis.getNumBytesRemaining())
+                {
+                    for (auto& destination : oscSettings.destinations)
+                        destination.lookahead = mis.readBool();
+                }
+                else
+                {
+                    DEBUG_LOG_ERROR("PluginProcessor: Lookahead destination count mismatch: " + juce::String(numDestinations));
+                }
+            }
+            updateOSCConnection();
+            DEBUG_LOG("PluginProcessor: Lookahead settings loaded");
+        }
+        
+        // 載入完整狀態的刷新頻率（如果存在）
+        if (!mis.isExhausted())
+        {
+            const double refreshRateHz = mis.readDouble();
+            {
+                juce::ScopedLock lock(oscSettingsLock);
+                oscSettings.refreshRateHz = std::isfinite(refreshRateHz) ? juce::jlimit(0.0, maxRefreshRateHz, refreshRateHz) : 0.0;
+            }
+            updateOSCConnection();
+            DEBUG_LOG("PluginProcessor: OSC refresh rate loaded");
+        }
+        
+        // 載入重新連線期間的處理方式（如果存在）
+        if (!mis.isExhausted())
+        {
+            const int numDestinations = mis.readInt();
+            {
+                juce::ScopedLock lock(oscSettingsLock);
+                if (numDestinations == static_cast<int>(oscSettings.destinations.size())
+                    && numDestinations <= mis.getNumBytesRemaining())
+                {
+                    for (auto& destination : oscSettings.destinations)
+                        destination.holdWhileReconnecting = mis.readBool();
+                }
+                else
+                {
+                    DEBUG_LOG_ERROR("PluginProcessor: Reconnect policy destination count mismatch: " + juce::String(numDestinations));
+                }
+            }
+            updateOSCConnection();
+            DEBUG_LOG("PluginProcessor: OSC reconnect policy loaded");
+        }
+        
+        // 載入是否發布流量統計（如果存在）
+        if (!mis.isExhausted())
+        {
+            {
+                juce::ScopedLock lock(oscSettingsLock);
+                oscSettings.publishStats = mis.readBool();
+            }
+            updateOSCConnection();
+            DEBUG_LOG("PluginProcessor: OSC stats publishing loaded");
+        }
+        
         DEBUG_LOG("PluginProcessor: setStateInformation completed");
     }
     catch (const std::exception& e)
@@ -308,90 +600,220 @@ void PlugDataCustomObjectAudioProcessor::setStateInformation (const void* data,
 }
 
 //==============================================================================
-void PlugDataCustomObjectAudioProcessor::updateOSCConnection()
+void PlugDataCustomObjectAudioProcessor::handleBallMoved(int ballId, float x, float y)
 {
-    oscSender.disconnect();
+    // 座標乘以 10 用於輸出
+    sendOSCMessage(ballId, x * 10.0f, y * 10.0f);
     
-    OSCSettings settings;
+    // 通知 Editor（如果有的話）在下一次 timer 時重繪
+    ballPositionsChanged = true;
+}
+
+void PlugDataCustomObjectAudioProcessor::sendScheduledPositions(double secondsFromBlockStart,
+                                                                const PlaybackEngine::ScheduledPosition* positions, int numPositions)
+{
+    // 球的列表在回放期間由 stateLock 保護（PlaybackEngine 在持有鎖時呼叫）
+    // 拿不到 frame 時不送出，否則提前的位置會立即送到所有目的地
+    if (!oscTransmitter.beginFrame(secondsFromBlockStart, OSCTransmitter::FrameTarget::scheduledDestinations))
+        return;
+    
+    char packet[OSCMessageTemplate::maxMessageSize];
+    for (int i = 0; i < numPositions; ++i)
     {
-        juce::ScopedLock lock(oscSettingsLock);
-        settings = oscSettings;
+        // 與 handleBallMoved 相同：座標乘以 10 用於輸出
+        const auto& position = positions[i];
+        const int packetSize = position.ball->xyMessage.writeFloats(packet, sizeof(packet), { position.x * 10.0f, position.y * 10.0f });
+        if (packetSize > 0)
+            oscTransmitter.send(packet, packetSize);
     }
     
-    if (settings.enabled)
+    oscTransmitter.endFrame();
+}
+
+void PlugDataCustomObjectAudioProcessor::refreshOSCState(int numSamples)
+{
+    const double rateHz = oscRefreshRateHz.load();
+    const double sampleRate = getSampleRate();
+    if (rateHz <= 0.0 || sampleRate <= 0.0 || !oscTransmitter.isEnabled())
     {
-        if (oscSender.connect(settings.ipAddress, settings.port))
-        {
-            DBG("OSC connected to " + settings.ipAddress + ":" + juce::String(settings.port));
-        }
-        else
-        {
-            DBG("Failed to connect OSC to " + settings.ipAddress + ":" + juce::String(settings.port));
-        }
+        refreshBallsDue = 0.0;
+        return;
     }
+    
+    // 不阻塞音訊線程：拿不到鎖時留到下一個 block（待重送的數量會累積）
+    const juce::ScopedTryLock lock(jyPad.getStateLock());
+    if (!lock.isLocked())
+        return;
+    
+    const auto& balls = jyPad.getAllBalls();
+    if (balls.empty())
+        return;
+    
+    // 每秒重送 numBalls * rateHz 個位置，平均分散到每個 block，避免一次送出所有球造成頻寬尖峰
+    const double numBalls = static_cast<double>(balls.size());
+    refreshBallsDue = juce::jmin(refreshBallsDue + numBalls * rateHz * numSamples / sampleRate, numBalls);
+    
+    const int numToSend = static_cast<int>(refreshBallsDue);
+    if (numToSend == 0)
+        return;
+    
+    refreshBallsDue -= numToSend;
+    
+    // 與回放的 tick 相同：bundle 模式的目的地合併成一個 bundle；
+    // 限制頻率的目的地只更新最新值，由發送線程依頻率送出
+    const bool inFrame = oscTransmitter.beginFrame(0.0);
+    
+    char packet[OSCMessageTemplate::maxMessageSize];
+    for (int i = 0; i < numToSend; ++i)
+    {
+        if (refreshCursor >= balls.size())
+            refreshCursor = 0;
+        
+        // 與 handleBallMoved 相同：座標乘以 10 用於輸出
+        const auto& ball = balls[refreshCursor++];
+        const int packetSize = ball.xyMessage.writeFloats(packet, sizeof(packet), { ball.x * 10.0f, ball.y * 10.0f });
+        if (packetSize > 0)
+            oscTransmitter.sendLatest(ball.id, packet, packetSize);
+    }
+    
+    if (inFrame)
+        oscTransmitter.endFrame();
 }
 
-void PlugDataCustomObjectAudioProcessor::sendOSCMessage(int ballId, float x, float y, [[maybe_unused]] float z)
+//==============================================================================
+void PlugDataCustomObjectAudioProcessor::updateOSCConnection()
 {
-    bool enabled;
+    OSCSettings settings;
     {
         juce::ScopedLock lock(oscSettingsLock);
-        enabled = oscSettings.enabled;
+        settings = oscSettings;
     }
     
-    if (!enabled)
+    // 不在這裡建立連線：每個目的地的 socket 由發送線程開啟（失敗時以退避時間重試），
+    // 所以建構、載入狀態與設定視窗都不會等待網路
+    oscTransmitter.setDestinations(settings.destinations, settings.enabled);
+    oscTransmitter.setPublishStats(settings.publishStats);
+    muteSoloState.invalidate();  // 接收端可能改變：下一次 mute/solo 送出所有來源
+    oscRefreshRateHz = std::isfinite(settings.refreshRateHz) ? juce::jlimit(0.0, maxRefreshRateHz, settings.refreshRateHz) : 0.0;
+    oscInput.setPort(settings.inputPort, settings.inputEnabled);
+}
+
+void PlugDataCustomObjectAudioProcessor::releaseRemovedOSCKeys()
+{
+    // 位置以球的 ID 作為最新值的 key：被刪除的球的槽位釋放給之後新增的球
+    const juce::ScopedLock lock(jyPad.getStateLock());
+    
+    std::vector<int> ballIds;
+    ballIds.reserve(jyPad.getAllBalls().size());
+    for (const auto& ball : jyPad.getAllBalls())
+        ballIds.push_back(ball.id);
+    
+    std::sort(ballIds.begin(), ballIds.end());
+    oscTransmitter.retainLatestKeys(ballIds);
+}
+
+void PlugDataCustomObjectAudioProcessor::rebuildOSCInputRoutes()
+{
+    // 與輸出相同的地址：{osc_prefix}/xy
+    const juce::ScopedLock lock(jyPad.getStateLock());
+    
+    std::vector<OSCInputReceiver::Route> routes;
+    routes.reserve(jyPad.getAllBalls().size());
+    for (const auto& ball : jyPad.getAllBalls())
+        routes.push_back({ ball.oscPrefix + "/xy", ball.id, ball.isRecording });
+    
+    oscInput.setRoutes(routes);
+}
+
+void PlugDataCustomObjectAudioProcessor::applyOSCInput(double nowMs)
+{
+    if (!oscInput.isEnabled())
+        return;
+    
+    // 拿不到鎖時位置留在抖動緩衝中，下一個 block 以新的時間重新取樣
+    const juce::ScopedTryLock lock(jyPad.getStateLock());
+    if (!lock.isLocked())
+        return;
+    
+    // 同一個 block 收到的所有位置在 bundle 模式的目的地中合併成一個 bundle
+    oscTransmitter.beginFrame(0.0);
+    
+    // 每個 block 取樣一次：輸出頻率固定為 block 頻率，不受封包到達時間影響
+    oscInput.renderPositions(nowMs, [this](int ballId, float x, float y)
+    {
+        // 與輸出相同的座標比例（輸出時乘以 10）
+        jyPad.setBallPosition(ballId, x / 10.0f, y / 10.0f);
+    });
+    
+    oscTransmitter.endFrame();
+}
+
+void PlugDataCustomObjectAudioProcessor::sendOSCMessage(int ballId, float x, float y, [[maybe_unused]] float z)
+{
+    // 可能在音訊線程中呼叫：不上鎖，直接看發送線程是否啟用
+    if (!oscTransmitter.isEnabled())
         return;
     
-    // 獲取球的 oscPrefix
+    // 獲取球的預先編碼樣板
     Ball* ball = jyPad.getBall(ballId);
     if (ball == nullptr)
         return;
     
     // OSC 發送格式：{osc_prefix}/xy x y（暫時不發送 z 值）
     // 例如：如果 oscPrefix = "/track/1"，則地址為 "/track/1/xy"，參數為 x, y
-    juce::String address = ball->oscPrefix + "/xy";
-    juce::OSCMessage message(address, x, y); // 只發送 x, y
+    // 地址與型別標籤在前綴改變時已編碼好，這裡只寫入兩個 float（不配置記憶體）
+    char packet[OSCMessageTemplate::maxMessageSize];
+    const int packetSize = ball->xyMessage.writeFloats(packet, sizeof(packet), { x, y });
+    if (packetSize == 0)
+        return;
     
-    // 記錄 OSC 訊息
-    if (oscMessageEditor != nullptr)
+    // 分送到每個目的地；設定了最大頻率的目的地只保存每個球的最新位置
+    if (!oscTransmitter.sendLatest(ballId, packet, packetSize))
     {
-        juce::String logMsg = address + " " + juce::String(x, 2) + " " + juce::String(y, 2);
-        oscMessageEditor->logOSCMessage(logMsg);
+        // 佇列滿或地址太長，封包被丟棄（發送線程會計數），不在這裡阻塞
+        return;
     }
     
-    if (!oscSender.send(message))
-    {
-        // 如果發送失敗，只記錄錯誤，不進行同步重新連接（這會導致音訊線程卡頓）
-        DEBUG_LOG_ERROR("Failed to send OSC message to " + address);
-        // updateOSCConnection();  // REMOVED synchronous reconnection
-        // oscSender.send(message); // REMOVED
-    }
+    // 記錄 OSC 訊息：只寫入固定大小的記錄環，由 Editor 顯示時格式化
+    if (oscMessageEditor.load(std::memory_order_relaxed) != nullptr)
+        oscMessageLog.push(OSCMessageLog::Kind::position, ballId, x, y);
 }
 
-void PlugDataCustomObjectAudioProcessor::sendMuteSoloOSCMessage(int ballId, bool isMute, bool isSolo)
+void PlugDataCustomObjectAudioProcessor::sendMuteSoloChanges()
 {
-    bool enabled;
-    {
-        juce::ScopedLock lock(oscSettingsLock);
-        enabled = oscSettings.enabled;
-    }
-    
-    if (!enabled)
+    // 沒有啟用的目的地時不計算（改變會留到下一次送出）
+    if (!oscTransmitter.isEnabled())
         return;
     
-    // 獲取球的信息
-    Ball* ball = jyPad.getBall(ballId);
-    if (ball == nullptr)
+    std::vector<MuteSoloState::Change> changes;
+    const juce::ScopedLock lock(jyPad.getStateLock());
+    muteSoloState.computeChanges(jyPad.getAllBalls(), changes);
+    
+    if (changes.empty())
         return;
     
-    // 發送 mute 訊息：{osc_prefix}/n/mute 1 或 0
-    // 其中 n 是 source number
+    // 所有改變合併成一個 bundle（超過封包大小時才拆開）
+    const bool inBundle = oscTransmitter.beginBundle();
+    
+    for (const auto& change : changes)
+        if (const Ball* ball = jyPad.getBall(change.ballId))
+            sendMuteSoloOSCMessage(*ball, change);
+    
+    if (inBundle)
+        oscTransmitter.endFrame();
+    
+    DEBUG_LOG("PluginProcessor: Sent mute/solo for " + juce::String(static_cast<int>(changes.size())) + " sources");
+}
+
+juce::String PlugDataCustomObjectAudioProcessor::getMuteSoloAddressPrefix(const Ball& ball)
+{
+    // mute/solo 的地址：{osc_prefix}/n，其中 n 是 source number
     // 例如：如果 oscPrefix = "/track/1"，sourceNumber = 1，則地址為 "/track/1/1/mute"
     // 但根據用戶需求，應該是 {osc_prefix}/n/mute，其中 osc_prefix 可能已經是 "/track"，n 是 source number
     // 為了保持一致性，我們假設 oscPrefix 是基礎前綴（如 "/track"），然後加上 source number
     // 但如果 oscPrefix 已經包含 source number（如 "/track/1"），我們需要提取基礎前綴
     // 暫時假設 oscPrefix 格式為 "/track/n"，我們需要提取 "/track" 部分
-    juce::String basePrefix = ball->oscPrefix;
+    juce::String basePrefix = ball.oscPrefix;
     // 如果 oscPrefix 以 "/track/" 開頭，提取基礎前綴
     if (basePrefix.startsWith("/track/"))
     {
@@ -403,39 +825,42 @@ void PlugDataCustomObjectAudioProcessor::sendMuteSoloOSCMessage(int ballId, bool
         }
     }
     
-    juce::String muteAddress = basePrefix + "/" + juce::String(ball->sourceNumber) + "/mute";
-    juce::OSCMessage muteMessage(muteAddress, isMute ? 1 : 0);
+    return basePrefix + "/" + juce::String(ball.sourceNumber);
+}
+
+void PlugDataCustomObjectAudioProcessor::sendMuteSoloOSCMessage(const Ball& ball, const MuteSoloState::Change& change)
+{
+    const juce::String addressPrefix = getMuteSoloAddressPrefix(ball);
     
-    // 記錄 OSC 訊息
-    if (oscMessageEditor != nullptr)
+    // 編碼單一 int 參數的訊息並放入發送佇列
+    auto enqueueIntMessage = [this](const juce::String& address, int value)
     {
-        juce::String logMsg = muteAddress + " " + juce::String(isMute ? 1 : 0);
-        oscMessageEditor->logOSCMessage(logMsg);
-    }
+        char packet[OSCTransmitter::maxPacketSize];
+        OSCPacketWriter writer(packet, sizeof(packet));
+        writer.beginMessage({ address.toRawUTF8() }, "i");
+        writer.writeInt32(value);
+        
+        if (!writer.isValid() || !oscTransmitter.send(packet, writer.getSize()))
+            DEBUG_LOG_ERROR("Failed to queue OSC message to " + address);
+    };
     
-    if (!oscSender.send(muteMessage))
+    // 發送 mute 訊息：{osc_prefix}/n/mute 1 或 0
+    if (change.muteChanged)
     {
-        DEBUG_LOG_ERROR("Failed to send OSC mute message to " + muteAddress);
-        // updateOSCConnection();
-        // oscSender.send(muteMessage);
+        // 記錄 OSC 訊息（只寫入記錄環，由 Editor 顯示時格式化）
+        if (oscMessageEditor.load(std::memory_order_relaxed) != nullptr)
+            oscMessageLog.push(OSCMessageLog::Kind::mute, ball.id, change.isMuted ? 1.0f : 0.0f);
+        
+        enqueueIntMessage(addressPrefix + "/mute", change.isMuted ? 1 : 0);
     }
     
     // 發送 solo 訊息：{osc_prefix}/n/solo 1 或 0
-    juce::String soloAddress = basePrefix + "/" + juce::String(ball->sourceNumber) + "/solo";
-    juce::OSCMessage soloMessage(soloAddress, isSolo ? 1 : 0);
-    
-    // 記錄 OSC 訊息
-    if (oscMessageEditor != nullptr)
+    if (change.soloChanged)
     {
-        juce::String logMsg = soloAddress + " " + juce::String(isSolo ? 1 : 0);
-        oscMessageEditor->logOSCMessage(logMsg);
-    }
-    
-    if (!oscSender.send(soloMessage))
-    {
-         DEBUG_LOG_ERROR("Failed to send OSC solo message to " + soloAddress);
-        // updateOSCConnection();
-        // oscSender.send(soloMessage);
+        if (oscMessageEditor.load(std::memory_order_relaxed) != nullptr)
+            oscMessageLog.push(OSCMessageLog::Kind::solo, ball.id, change.isSoloed ? 1.0f : 0.0f);
+        
+        enqueueIntMessage(addressPrefix + "/solo", change.isSoloed ? 1 : 0);
     }
 }
 
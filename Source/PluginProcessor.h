@@ -4,6 +4,13 @@
 #include <juce_audio_basics/juce_audio_basics.h>
 #include <juce_osc/juce_osc.h>
 #include "JYPad.h"
+#include "PlaybackEngine.h"
+#include "TrajectorySimplifier.h"
+#include "OSCTransmitter.h"
+#include "OSCInputReceiver.h"
+#include "MuteSoloState.h"
+#include "OSCMessageLog.h"
+#include "PlayheadClock.h"
 #include "DataTable.h"
 
 //==============================================================================
@@ -59,6 +66,16 @@ public:
     // JYPad 物件實例
     JYPad jyPad;
     
+    // 回放引擎（在 processBlock 中推進，不依賴 Editor）
+    PlaybackEngine playbackEngine { jyPad };
+    
+    // 背景簡化錄製數據（ballIds 為空時處理所有球），完成後在訊息線程呼叫 onComplete
+    void simplifyRecordingsAsync(std::vector<int> ballIds, float tolerance,
+                                 std::function<void(const TrajectorySimplifier::Result&)> onComplete);
+    
+    // 球的位置是否在上次查詢後改變過（供 Editor 的 timer 決定是否重繪）
+    bool consumeBallPositionsChanged() noexcept { return ballPositionsChanged.exchange(false); }
+    
     //==============================================================================
     // 數據表格（會保存在插件狀態中）
     DataTable dataTable;
@@ -72,15 +89,38 @@ public:
     // OSC 設置和發送器
     struct OSCSettings
     {
-        juce::String ipAddress = "127.0.0.1";
-        int port = 4002;
-        bool enabled = true;
+        bool enabled = true;  // 所有目的地的總開關
+        std::vector<OSCDestination::Settings> destinations { OSCDestination::Settings() };
+        
+        // 完整狀態的刷新頻率（每秒重送所有球的位置幾次），0 表示只送出改變
+        // 重送分散在每個 audio block 中，接收端遺失封包後最多 1 / refreshRateHz 秒就會恢復
+        double refreshRateHz = 0.0;
+        
+        // 每秒把每個目的地的流量統計以 /jypad/stats 送到該目的地
+        bool publishStats = false;
+        
+        // OSC 輸入（遠端控制球的位置）：{osc_prefix}/xy x y
+        bool inputEnabled = false;
+        int inputPort = 4003;
     };
     
     OSCSettings oscSettings;
-    juce::OSCSender oscSender;
     
-    // 更新 OSC 連接
+    // 完整狀態刷新頻率的上限
+    static constexpr double maxRefreshRateHz = 50.0;
+    
+    // OSC 發送線程（封包在呼叫端編碼後分送到每個目的地的無鎖佇列，由發送線程寫入 socket）
+    OSCTransmitter oscTransmitter;
+    
+    // 主機播放位置（processBlock 更新；OSC 輸入線程用來推算封包到達時的 PPQ）
+    // 宣告在 oscInput 之前，確保輸入線程停止後才被解構
+    PlayheadClock playheadClock;
+    
+    // OSC 輸入線程（經路由表對應到球後放入抖動緩衝，在 processBlock 中重新取樣並套用到 JYPad）
+    // 錄製中的球收到的每一個位置都直接推入 JYPad 的擷取佇列（CaptureProducer::oscInput）
+    OSCInputReceiver oscInput;
+    
+    // 更新 OSC 連接（把 oscSettings 套用到發送線程與輸入線程）
     void updateOSCConnection();
     
     // 發送 OSC 訊息（當球移動時）
@@ -88,11 +128,18 @@ public:
     // TODO: 未來實作 z 軸錄影後，可以改為發送 x, y, z
     void sendOSCMessage(int ballId, float x, float y, float z = 0.0f);
     
-    // 發送 mute/solo OSC 訊息
-    // 格式：{osc_prefix}/n/mute 1 或 0
+    // 發送 mute/solo 的改變（訊息線程，在修改球的 isMuted / isSoloed 之後呼叫）
+    // 只送出有效狀態改變的來源，合併成一個 bundle
+    // 格式：{osc_prefix}/n/mute 1 或 0（有效狀態：其他球 solo 時也是 1）
     // 格式：{osc_prefix}/n/solo 1 或 0
     // 其中 n 是 source number
-    void sendMuteSoloOSCMessage(int ballId, bool isMute, bool isSolo);
+    void sendMuteSoloChanges();
+    
+    // mute/solo 訊息的地址前綴：{osc_prefix}/n（n 是 source number）
+    static juce::String getMuteSoloAddressPrefix(const Ball& ball);
+    
+    // 送出的 OSC 訊息記錄（Editor 開啟時寫入；發送端只寫入二進位記錄，顯示時才格式化）
+    OSCMessageLog oscMessageLog;
     
     // OSC 設置的線程安全鎖（供 UI 使用）
     mutable juce::CriticalSection oscSettingsLock;
@@ -143,12 +190,46 @@ public:
     TimeCodeInfo getTimeCodeInfo() const;
 
 private:
+    //==============================================================================
+    // 球移動時的處理（可能在音訊線程或訊息線程中被呼叫）
+    void handleBallMoved(int ballId, float x, float y);
+    
+    std::atomic<bool> ballPositionsChanged { false };
+    
+    // 上次送出的 mute/solo 狀態
+    MuteSoloState muteSoloState;
+    
+    // 完整狀態刷新（音訊線程）：每個 block 重送一部分球目前的位置
+    void refreshOSCState(int numSamples);
+    
+    std::atomic<double> oscRefreshRateHz { 0.0 };  // oscSettings.refreshRateHz 的副本，供音訊線程讀取
+    double refreshBallsDue = 0.0;                  // 累積的待重送球數（小數部分留到下一個 block）
+    size_t refreshCursor = 0;                      // 下一個要重送的球的索引
+    
+    // 編碼並送出一個來源改變的 mute/solo 訊息
+    void sendMuteSoloOSCMessage(const Ball& ball, const MuteSoloState::Change& change);
+    
+    // 把提前排程的回放位置以一個 frame 送到 lookahead 目的地（音訊線程）
+    void sendScheduledPositions(double secondsFromBlockStart, const PlaybackEngine::ScheduledPosition* positions, int numPositions);
+    
+    // 把 OSC 輸入抖動緩衝在 nowMs 時刻重新取樣的位置套用到球上（音訊線程）
+    void applyOSCInput(double nowMs);
+    
+    // 以目前的球列表重建 OSC 輸入的路由表（球被新增、刪除、前綴或錄製狀態改變時）
+    void rebuildOSCInputRoutes();
+    
+    // 釋放已刪除的球在發送端最新值表中的槽位
+    void releaseRemovedOSCKeys();
+    
+    // 離線處理用的背景線程（宣告在 jyPad 之後，解構時先等工作結束）
+    juce::ThreadPool backgroundJobs { 1 };
+    
     //==============================================================================
     // 時間碼資訊緩存（在 processBlock 中更新，在 UI 中讀取）
     TimeCodeInfo cachedTimeCodeInfo;
     
-    // Editor 指針（用於記錄 OSC 訊息）
-    PlugDataCustomObjectAudioProcessorEditor* oscMessageEditor = nullptr;
+    // Editor 指針（用於記錄 OSC 訊息）：音訊線程讀取，Editor 建立 / 解構時寫入
+    std::atomic<PlugDataCustomObjectAudioProcessorEditor*> oscMessageEditor { nullptr };
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PlugDataCustomObjectAudioProcessor)
 };
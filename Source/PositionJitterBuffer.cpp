@@ -0,0 +1,273 @@
+#include "PositionJitterBuffer.h"
+#include <cmath>
+
+//==============================================================================
+namespace
+{
+    // DLL 的頻寬（Hz）：越小越能抵抗抖動，但追蹤頻率變化越慢
+    constexpr double clockBandwidthHz = 0.5;
+
+    // 鎖定前用來估計初始週期的樣本數
+    constexpr int warmupSamples = 8;
+
+    // 到達時間與預測相差超過這個值就重新鎖定（串流中斷或重新開始）
+    constexpr double clockResetThresholdMs = 250.0;
+
+    constexpr double minPeriodMs = 0.25;
+    constexpr double maxPeriodMs = 250.0;
+
+    // 播放時間每次 render 前進的速度範圍（相對於實際時間）：
+    // 延遲改變時平滑地追上，而不是讓輸出跳回過去
+    constexpr double minPlayoutSpeed = 0.5;
+    constexpr double maxPlayoutSpeed = 1.5;
+
+    // 抖動估計：誤差變大時快速跟上，變小時慢慢回落（延遲要涵蓋偶發的成批延遲）
+    constexpr double jitterAttack = 0.5;
+    constexpr double jitterRelease = 0.002;
+}
+
+//==============================================================================
+PositionJitterBuffer::PositionJitterBuffer()
+    : slots(new Slot[numSlots])
+{
+    static_assert((numSlots & (numSlots - 1)) == 0, "numSlots must be a power of two");
+    static_assert((samplesPerSlot & (samplesPerSlot - 1)) == 0, "samplesPerSlot must be a power of two");
+}
+
+//==============================================================================
+PositionJitterBuffer::Slot* PositionJitterBuffer::findOrClaimSlot(int key) noexcept
+{
+    constexpr juce::uint32 mask = static_cast<juce::uint32>(numSlots - 1);
+    juce::uint32 index = (static_cast<juce::uint32>(key) * 2654435761u) & mask;
+
+    // 線性探測；只有一個生產者，所以佔用槽位不需要 compare-exchange
+    for (int probe = 0; probe < numSlots; ++probe)
+    {
+        Slot& slot = slots[index];
+        const int existing = slot.key.load(std::memory_order_relaxed);
+
+        if (existing == key)
+            return &slot;
+
+        if (existing == emptyKey)
+        {
+            slot.key.store(key, std::memory_order_release);
+            return &slot;
+        }
+
+        index = (index + 1) & mask;
+    }
+
+    return nullptr;
+}
+
+bool PositionJitterBuffer::push(int key, float x, float y, double arrivalTimeMs, double& smoothedTimeMs) noexcept
+{
+    Slot* slot = findOrClaimSlot(key);
+    if (slot == nullptr)
+        return false;
+
+    smoothedTimeMs = smoothArrivalTime(*slot, arrivalTimeMs);
+
+    const juce::uint32 index = slot->writeIndex.load(std::memory_order_relaxed);
+    Entry& entry = slot->entries[index & (samplesPerSlot - 1)];
+
+    entry.sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    entry.sample.timeMs = smoothedTimeMs;
+    entry.sample.x = x;
+    entry.sample.y = y;
+
+    entry.sequence.store(index + 1, std::memory_order_release);
+    slot->writeIndex.store(index + 1, std::memory_order_release);
+    return true;
+}
+
+double PositionJitterBuffer::smoothArrivalTime(Slot& slot, double arrivalTimeMs) noexcept
+{
+    // 第一個樣本：開始估計初始週期
+    if (slot.clockState == 0)
+    {
+        slot.clockState = 1;
+        slot.filteredTimeMs = arrivalTimeMs;
+        slot.estimatedPeriodMs = 0.0;
+        slot.estimatedJitterMs = 0.0;
+        slot.warmupCount = 0;
+        return arrivalTimeMs;
+    }
+
+    // 暖身：以前幾個樣本的平均間隔作為初始週期（單一間隔在成批到達時可能接近 0）
+    if (slot.clockState == 1)
+    {
+        ++slot.warmupCount;
+        const double elapsedMs = arrivalTimeMs - slot.filteredTimeMs;
+
+        if (elapsedMs > clockResetThresholdMs || elapsedMs < 0.0)
+        {
+            slot.clockState = 0;
+            return smoothArrivalTime(slot, arrivalTimeMs);
+        }
+
+        if (slot.warmupCount < warmupSamples)
+            return arrivalTimeMs;
+
+        slot.estimatedPeriodMs = juce::jlimit(minPeriodMs, maxPeriodMs, elapsedMs / slot.warmupCount);
+        slot.filteredTimeMs = arrivalTimeMs;
+        slot.predictedTimeMs = arrivalTimeMs + slot.estimatedPeriodMs;
+        slot.clockState = 2;
+
+        slot.periodMs.store(slot.estimatedPeriodMs, std::memory_order_relaxed);
+        slot.playoutDelayMs.store(juce::jmin(maxPlayoutDelayMs, slot.estimatedPeriodMs), std::memory_order_relaxed);
+        return arrivalTimeMs;
+    }
+
+    // 已鎖定：二階 DLL，誤差同時修正時間與週期（週期的變化就是兩邊時鐘的漂移）
+    const double error = arrivalTimeMs - slot.predictedTimeMs;
+
+    if (std::abs(error) > clockResetThresholdMs)
+    {
+        ++numClockResets;
+        slot.clockState = 0;
+        return smoothArrivalTime(slot, arrivalTimeMs);
+    }
+
+    const double omega = juce::MathConstants<double>::twoPi * clockBandwidthHz * slot.estimatedPeriodMs / 1000.0;
+    const double b = juce::MathConstants<double>::sqrt2 * omega;
+    const double c = omega * omega;
+
+    // 平滑後的時間必須遞增，否則消費者會看到時間倒退的樣本
+    slot.filteredTimeMs = juce::jmax(slot.predictedTimeMs + b * error, slot.filteredTimeMs + 0.001);
+    slot.estimatedPeriodMs = juce::jlimit(minPeriodMs, maxPeriodMs, slot.estimatedPeriodMs + c * error);
+    slot.predictedTimeMs = slot.filteredTimeMs + slot.estimatedPeriodMs;
+
+    const double jitterError = std::abs(error) - slot.estimatedJitterMs;
+    slot.estimatedJitterMs += jitterError * (jitterError > 0.0 ? jitterAttack : jitterRelease);
+
+    // 播放延遲：至少一個週期（才有下一個樣本可以插值），再加上抖動的峰值
+    const double delayMs = juce::jmin(maxPlayoutDelayMs, slot.estimatedPeriodMs + slot.estimatedJitterMs);
+
+    slot.periodMs.store(slot.estimatedPeriodMs, std::memory_order_relaxed);
+    slot.jitterMs.store(slot.estimatedJitterMs, std::memory_order_relaxed);
+    slot.playoutDelayMs.store(delayMs, std::memory_order_relaxed);
+
+    return slot.filteredTimeMs;
+}
+
+//==============================================================================
+bool PositionJitterBuffer::readEntry(const Slot& slot, juce::uint32 index, Sample& sample) const noexcept
+{
+    const Entry& entry = slot.entries[index & (samplesPerSlot - 1)];
+
+    if (entry.sequence.load(std::memory_order_acquire) != index + 1)
+        return false;
+
+    sample = entry.sample;
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return entry.sequence.load(std::memory_order_relaxed) == index + 1;
+}
+
+bool PositionJitterBuffer::renderSlot(Slot& slot, double nowMs, float& x, float& y) noexcept
+{
+    const double targetTimeMs = nowMs - slot.playoutDelayMs.load(std::memory_order_relaxed);
+
+    if (!slot.hasPrevious || std::abs(targetTimeMs - slot.playoutTimeMs) > maxPlayoutDelayMs)
+    {
+        slot.playoutTimeMs = targetTimeMs;  // 第一次，或中斷太久：直接跳到目標
+    }
+    else
+    {
+        const double elapsedMs = juce::jmax(0.0, nowMs - slot.lastRenderTimeMs);
+        slot.playoutTimeMs = juce::jlimit(slot.playoutTimeMs + elapsedMs * minPlayoutSpeed,
+                                          slot.playoutTimeMs + elapsedMs * maxPlayoutSpeed,
+                                          targetTimeMs);
+    }
+
+    slot.lastRenderTimeMs = nowMs;
+
+    const double playoutTimeMs = slot.playoutTimeMs;
+    const juce::uint32 writeIndex = slot.writeIndex.load(std::memory_order_acquire);
+
+    // 消費者落後太多時，跳過已經被覆蓋（或即將被覆蓋）的樣本
+    constexpr juce::uint32 readableSamples = samplesPerSlot - 2;
+    if (writeIndex - slot.readIndex > readableSamples)
+        slot.readIndex = writeIndex - readableSamples;
+
+    Sample next;
+    bool hasNext = false;
+
+    while (slot.readIndex != writeIndex)
+    {
+        Sample sample;
+        if (!readEntry(slot, slot.readIndex, sample))
+        {
+            ++slot.readIndex;  // 讀取時被覆蓋
+            continue;
+        }
+
+        if (sample.timeMs > playoutTimeMs)
+        {
+            next = sample;
+            hasNext = true;
+            break;
+        }
+
+        slot.previous = sample;
+        slot.hasPrevious = true;
+        slot.holding = false;
+        ++slot.readIndex;
+    }
+
+    // 第一個樣本還沒到播放時間
+    if (!slot.hasPrevious)
+        return false;
+
+    if (hasNext)
+    {
+        const double span = next.timeMs - slot.previous.timeMs;
+        const auto t = static_cast<float>(span > 0.0 ? juce::jlimit(0.0, 1.0, (playoutTimeMs - slot.previous.timeMs) / span) : 1.0);
+
+        x = slot.previous.x + (next.x - slot.previous.x) * t;
+        y = slot.previous.y + (next.y - slot.previous.y) * t;
+        slot.holding = false;
+        return true;
+    }
+
+    // 緩衝用完：輸出最後一個樣本一次，之後保持不動直到新的樣本到達
+    if (slot.holding)
+        return false;
+
+    slot.holding = true;
+    ++numUnderruns;
+
+    x = slot.previous.x;
+    y = slot.previous.y;
+    return true;
+}
+
+//==============================================================================
+PositionJitterBuffer::Stats PositionJitterBuffer::getStats() const noexcept
+{
+    Stats stats;
+
+    for (int i = 0; i < numSlots; ++i)
+    {
+        const Slot& slot = slots[static_cast<size_t>(i)];
+        if (slot.key.load(std::memory_order_acquire) == emptyKey)
+            continue;
+
+        const double periodMs = slot.periodMs.load(std::memory_order_relaxed);
+        if (periodMs <= 0.0)
+            continue;
+
+        const double rateHz = 1000.0 / periodMs;
+        stats.minRateHz = (stats.numSources == 0) ? rateHz : juce::jmin(stats.minRateHz, rateHz);
+        stats.maxRateHz = juce::jmax(stats.maxRateHz, rateHz);
+        stats.maxJitterMs = juce::jmax(stats.maxJitterMs, slot.jitterMs.load(std::memory_order_relaxed));
+        stats.maxPlayoutDelayMs = juce::jmax(stats.maxPlayoutDelayMs, slot.playoutDelayMs.load(std::memory_order_relaxed));
+        ++stats.numSources;
+    }
+
+    return stats;
+}
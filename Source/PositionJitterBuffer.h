@@ -0,0 +1,130 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <atomic>
+#include <limits>
+#include <memory>
+
+//==============================================================================
+/**
+ * 外部位置輸入的抖動緩衝與重新取樣
+ * 追蹤器的 UDP 串流到達時間不規則（成批到達、偶爾延遲），直接套用會讓輸出跟著抖動。
+ * 每個來源（球的 ID）有自己的環形緩衝：
+ *
+ *  - 生產者（接收線程）用延遲鎖定迴路（DLL）平滑到達時間：
+ *    估計發送端實際的週期（包含時鐘漂移），把每個樣本放在平滑後的時間軸上，
+ *    並以誤差的峰值估計抖動，決定播放延遲（週期 + 抖動）。
+ *  - 消費者（音訊線程）在每個 block 以「現在 - 播放延遲」的時刻，
+ *    在前後兩個樣本之間線性插值，所以輸出是固定頻率、不抖動的位置。
+ *    緩衝用完時停在最後一個位置（不外插）。
+ *
+ * push() 只能由單一生產者線程呼叫；render() 只能由單一消費者線程呼叫；兩者都不配置記憶體。
+ * 時間單位都是 juce::Time::getMillisecondCounterHiRes() 的毫秒。
+ */
+class PositionJitterBuffer
+{
+public:
+    static constexpr int numSlots = 512;
+    static constexpr int samplesPerSlot = 32;
+
+    // 播放延遲的上限（毫秒）
+    static constexpr double maxPlayoutDelayMs = 100.0;
+
+    PositionJitterBuffer();
+
+    // 加入一個位置（生產者），返回平滑後的時間（毫秒）；來源數量超過槽位數時返回 false
+    bool push(int key, float x, float y, double arrivalTimeMs, double& smoothedTimeMs) noexcept;
+
+    // 對每個輸出有變化的來源呼叫 consume(int key, float x, float y)（消費者）
+    template <typename Consume>
+    int render(double nowMs, Consume&& consume) noexcept
+    {
+        int numRendered = 0;
+
+        for (int i = 0; i < numSlots; ++i)
+        {
+            Slot& slot = slots[static_cast<size_t>(i)];
+            const int key = slot.key.load(std::memory_order_acquire);
+            if (key == emptyKey)
+                continue;
+
+            float x = 0.0f, y = 0.0f;
+            if (renderSlot(slot, nowMs, x, y))
+            {
+                consume(key, x, y);
+                ++numRendered;
+            }
+        }
+
+        return numRendered;
+    }
+
+    // 統計（供 UI 顯示，任何線程）
+    struct Stats
+    {
+        int numSources = 0;
+        double maxJitterMs = 0.0;
+        double maxPlayoutDelayMs = 0.0;
+        double minRateHz = 0.0;   // 估計的發送頻率
+        double maxRateHz = 0.0;
+    };
+
+    Stats getStats() const noexcept;
+    juce::uint64 getNumUnderruns() const noexcept { return numUnderruns.load(std::memory_order_relaxed); }
+    juce::uint64 getNumClockResets() const noexcept { return numClockResets.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr int emptyKey = std::numeric_limits<int>::min();
+
+    struct Sample
+    {
+        double timeMs = 0.0;
+        float x = 0.0f;
+        float y = 0.0f;
+    };
+
+    struct Entry
+    {
+        std::atomic<juce::uint32> sequence { 0 };   // 寫入完成後為 index + 1
+        Sample sample;
+    };
+
+    struct Slot
+    {
+        std::atomic<int> key { emptyKey };
+        std::atomic<juce::uint32> writeIndex { 0 };
+        Entry entries[samplesPerSlot];
+
+        // 生產者發布的估計值
+        std::atomic<double> playoutDelayMs { 0.0 };
+        std::atomic<double> jitterMs { 0.0 };
+        std::atomic<double> periodMs { 0.0 };
+
+        // 只有生產者使用：DLL 狀態
+        int clockState = 0;         // 0 = 沒有樣本，1 = 暖身中，2 = 已鎖定
+        int warmupCount = 0;
+        double filteredTimeMs = 0.0;
+        double predictedTimeMs = 0.0;
+        double estimatedPeriodMs = 0.0;
+        double estimatedJitterMs = 0.0;
+
+        // 只有消費者使用
+        juce::uint32 readIndex = 0;
+        double playoutTimeMs = 0.0;
+        double lastRenderTimeMs = 0.0;
+        Sample previous;
+        bool hasPrevious = false;
+        bool holding = false;       // 已經輸出最後一個樣本，等待新的樣本
+    };
+
+    std::unique_ptr<Slot[]> slots;
+    std::atomic<juce::uint64> numUnderruns { 0 };
+    std::atomic<juce::uint64> numClockResets { 0 };
+
+    Slot* findOrClaimSlot(int key) noexcept;
+    double smoothArrivalTime(Slot& slot, double arrivalTimeMs) noexcept;
+    bool readEntry(const Slot& slot, juce::uint32 index, Sample& sample) const noexcept;
+    bool renderSlot(Slot& slot, double nowMs, float& x, float& y) noexcept;
+
+    JUCE_DECLARE_NON_COPYABLE(PositionJitterBuffer)
+};
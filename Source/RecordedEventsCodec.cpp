@@ -0,0 +1,356 @@
+#include "RecordedEventsCodec.h"
+#include "DebugLogger.h"
+#include <cmath>
+#include <limits>
+#include <vector>
+
+//==============================================================================
+namespace
+{
+    // 超過 2^53 的量化值無法以 double 精確還原，限制在這個範圍內
+    constexpr double maxQuantisedValue = 9007199254740992.0;
+
+    juce::int64 quantise(double value, double scale) noexcept
+    {
+        return static_cast<juce::int64>(std::llround(juce::jlimit(-maxQuantisedValue, maxQuantisedValue, value * scale)));
+    }
+
+    juce::uint64 zigzagEncode(juce::int64 value) noexcept
+    {
+        return (static_cast<juce::uint64>(value) << 1) ^ static_cast<juce::uint64>(value >> 63);
+    }
+
+    juce::int64 zigzagDecode(juce::uint64 value) noexcept
+    {
+        return static_cast<juce::int64>(value >> 1) ^ -static_cast<juce::int64>(value & 1);
+    }
+
+    void writeVarint(std::vector<juce::uint8>& out, juce::uint64 value)
+    {
+        while (value >= 0x80)
+        {
+            out.push_back(static_cast<juce::uint8>(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<juce::uint8>(value));
+    }
+
+    // 對一個欄位寫入量化後的差分值
+    template <typename T>
+    void writeDeltaColumn(std::vector<juce::uint8>& out, ColumnSpan<T> column, double scale)
+    {
+        juce::int64 previous = 0;
+        for (const T value : column)
+        {
+            const juce::int64 q = quantise(static_cast<double>(value), scale);
+            writeVarint(out, zigzagEncode(q - previous));
+            previous = q;
+        }
+    }
+
+    // 有邊界檢查的 varint 讀取器；讀超過結尾時 failed 設為 true
+    struct VarintReader
+    {
+        const juce::uint8* data;
+        size_t size;
+        size_t position = 0;
+        bool failed = false;
+
+        juce::uint64 read() noexcept
+        {
+            juce::uint64 result = 0;
+            for (int shift = 0; shift < 64; shift += 7)
+            {
+                if (position >= size)
+                {
+                    failed = true;
+                    return 0;
+                }
+
+                const juce::uint8 byte = data[position++];
+                result |= static_cast<juce::uint64>(byte & 0x7f) << shift;
+
+                if ((byte & 0x80) == 0)
+                    return result;
+            }
+
+            failed = true;  // 超過 10 bytes，不是合法的 varint
+            return 0;
+        }
+
+        size_t remaining() const noexcept { return size - position; }
+    };
+
+    template <typename T>
+    bool readDeltaColumn(VarintReader& reader, std::vector<T>& column, size_t numEvents, double scale)
+    {
+        column.resize(numEvents);
+        juce::int64 previous = 0;
+        for (size_t i = 0; i < numEvents; ++i)
+        {
+            previous += zigzagDecode(reader.read());
+            column[i] = static_cast<T>(static_cast<double>(previous) / scale);
+        }
+        return !reader.failed;
+    }
+
+    bool isFiniteEvent(const EventLane& lane, size_t i) noexcept
+    {
+        return std::isfinite(lane.getTime(i)) && std::isfinite(lane.getXs()[i])
+            && std::isfinite(lane.getYs()[i]) && std::isfinite(lane.getZs()[i]);
+    }
+}
+
+//==============================================================================
+void RecordedEventsCodec::write(juce::OutputStream& stream, const std::map<int, EventLane>& lanes)
+{
+    const double timeScale = defaultTimeScale;
+    const double coordScale = defaultCoordScale;
+
+    size_t totalEvents = 0;
+    int numLanes = 0;
+    for (const auto& pair : lanes)
+    {
+        totalEvents += pair.second.size();
+        if (!pair.second.empty())
+            ++numLanes;
+    }
+
+    std::vector<juce::uint8> payload;
+    payload.reserve(16 + totalEvents * 8);
+
+    writeVarint(payload, static_cast<juce::uint64>(numLanes));
+
+    for (const auto& [ballId, sourceLane] : lanes)
+    {
+        if (sourceLane.empty())
+            continue;
+
+        // NaN/Inf 無法量化；極少發生，出現時才複製一份去除它們
+        const EventLane* lane = &sourceLane;
+        EventLane cleaned;
+        bool allFinite = true;
+        for (size_t i = 0; i < sourceLane.size() && allFinite; ++i)
+            allFinite = isFiniteEvent(sourceLane, i);
+
+        if (!allFinite)
+        {
+            DEBUG_LOG_ERROR("RecordedEventsCodec: Dropping NaN/Inf events for ball " + juce::String(ballId));
+            for (size_t i = 0; i < sourceLane.size(); ++i)
+                if (isFiniteEvent(sourceLane, i))
+                    cleaned.append(sourceLane.getTime(i), sourceLane.getXs()[i], sourceLane.getYs()[i], sourceLane.getZs()[i]);
+            lane = &cleaned;
+        }
+
+        const auto zs = lane->getZs();
+        const bool hasZ = std::any_of(zs.begin(), zs.end(), [](float z) { return z != 0.0f; });
+
+        writeVarint(payload, zigzagEncode(ballId));
+        writeVarint(payload, static_cast<juce::uint64>(lane->size()));
+        writeVarint(payload, hasZ ? static_cast<juce::uint64>(laneHasZ) : 0);
+
+        writeDeltaColumn(payload, lane->getTimes(), timeScale);
+        writeDeltaColumn(payload, lane->getXs(), coordScale);
+        writeDeltaColumn(payload, lane->getYs(), coordScale);
+        if (hasZ)
+            writeDeltaColumn(payload, zs, coordScale);
+    }
+
+    int flags = 0;
+    juce::MemoryOutputStream compressed;
+
+    if (payload.size() > compressionThreshold)
+    {
+        {
+            juce::GZIPCompressorOutputStream gzip(compressed);
+            gzip.write(payload.data(), payload.size());
+        }
+
+        // 壓縮後沒有變小就保存原始 payload
+        if (compressed.getDataSize() < payload.size())
+            flags |= payloadIsCompressed;
+    }
+
+    const bool isCompressed = (flags & payloadIsCompressed) != 0;
+    const void* data = isCompressed ? compressed.getData() : payload.data();
+    const size_t dataSize = isCompressed ? compressed.getDataSize() : payload.size();
+
+    stream.writeInt(currentVersion);
+    stream.writeInt(flags);
+    stream.writeDouble(timeScale);
+    stream.writeDouble(coordScale);
+
+    // 壓縮的 payload 前面加上解壓縮後的大小，讀取時據此限制解壓縮的數據量
+    if (isCompressed)
+    {
+        stream.writeInt(static_cast<int>(dataSize + sizeof(juce::int32)));
+        stream.writeInt(static_cast<int>(payload.size()));
+    }
+    else
+    {
+        stream.writeInt(static_cast<int>(dataSize));
+    }
+    stream.write(data, dataSize);
+
+    DEBUG_LOG("RecordedEventsCodec: Wrote " + juce::String(static_cast<juce::int64>(totalEvents)) + " events in "
+              + juce::String(static_cast<juce::int64>(dataSize)) + " bytes"
+              + ((flags & payloadIsCompressed) ? " (compressed)" : ""));
+}
+
+//==============================================================================
+RecordedEventsCodec::ReadResult RecordedEventsCodec::read(juce::InputStream& stream, std::map<int, EventLane>& lanes)
+{
+    // 標頭的佈局在所有版本中固定，所以即使版本不支援也能跳過整個區塊
+    const int version = stream.readInt();
+    const int flags = stream.readInt();
+    const double timeScale = stream.readDouble();
+    const double coordScale = stream.readDouble();
+    const int payloadSize = stream.readInt();
+
+    if (payloadSize < 0 || payloadSize > stream.getNumBytesRemaining())
+    {
+        DEBUG_LOG_ERROR("RecordedEventsCodec: Invalid payload size: " + juce::String(payloadSize));
+        return ReadResult::streamCorrupt;
+    }
+
+    juce::MemoryBlock payload;
+    if (stream.readIntoMemoryBlock(payload, payloadSize) != static_cast<size_t>(payloadSize))
+    {
+        DEBUG_LOG_ERROR("RecordedEventsCodec: Stream ended inside payload");
+        return ReadResult::streamCorrupt;
+    }
+
+    // 以下的錯誤都發生在整個區塊讀完之後，呼叫者可以繼續讀取之後的數據
+    if (version < 1 || version > currentVersion)
+    {
+        DEBUG_LOG_ERROR("RecordedEventsCodec: Unsupported version " + juce::String(version) + ", skipping recorded events");
+        return ReadResult::skipped;
+    }
+
+    if (!(std::isfinite(timeScale) && timeScale > 0.0 && std::isfinite(coordScale) && coordScale > 0.0))
+    {
+        DEBUG_LOG_ERROR("RecordedEventsCodec: Invalid quantisation scales");
+        return ReadResult::skipped;
+    }
+
+    if (flags & payloadIsCompressed)
+    {
+        const auto* data = static_cast<const char*>(payload.getData());
+        size_t size = payload.getSize();
+        juce::int64 decodedSize = -1;
+
+        if (version >= 2)
+        {
+            if (size < sizeof(juce::int32))
+            {
+                DEBUG_LOG_ERROR("RecordedEventsCodec: Compressed payload is missing its size");
+                return ReadResult::skipped;
+            }
+
+            decodedSize = juce::ByteOrder::littleEndianInt(data);
+            data += sizeof(juce::int32);
+            size -= sizeof(juce::int32);
+        }
+
+        juce::MemoryBlock decompressed;
+        if (!decompressPayload(data, size, decodedSize, decompressed))
+            return ReadResult::skipped;
+
+        payload.swapWith(decompressed);
+    }
+
+    std::map<int, EventLane> decoded;
+    if (!decodePayload(static_cast<const juce::uint8*>(payload.getData()), payload.getSize(),
+                       timeScale, coordScale, decoded))
+    {
+        DEBUG_LOG_ERROR("RecordedEventsCodec: Corrupt payload, skipping recorded events");
+        return ReadResult::skipped;
+    }
+
+    lanes.swap(decoded);
+    return ReadResult::loaded;
+}
+
+bool RecordedEventsCodec::decompressPayload(const void* data, size_t size, juce::int64 decodedSize, juce::MemoryBlock& decoded)
+{
+    if (decodedSize > static_cast<juce::int64>(maxDecodedPayloadSize))
+    {
+        DEBUG_LOG_ERROR("RecordedEventsCodec: Decoded payload too large: " + juce::String(decodedSize));
+        return false;
+    }
+
+    // 很小的壓縮數據可以解壓縮成非常大的數據：最多只讀到上限多一個 byte，用來判斷是否超過
+    const size_t limit = decodedSize >= 0 ? static_cast<size_t>(decodedSize) : maxDecodedPayloadSize;
+
+    juce::MemoryInputStream compressedStream(data, size, false);
+    juce::GZIPDecompressorInputStream gzip(compressedStream);
+
+    const size_t numRead = gzip.readIntoMemoryBlock(decoded, static_cast<ssize_t>(limit) + 1);
+
+    if (numRead > limit || (decodedSize >= 0 && numRead != static_cast<size_t>(decodedSize)))
+    {
+        DEBUG_LOG_ERROR("RecordedEventsCodec: Decompressed payload exceeds " + juce::String(static_cast<juce::int64>(limit))
+                        + " bytes or does not match its declared size, skipping recorded events");
+        return false;
+    }
+
+    return true;
+}
+
+bool RecordedEventsCodec::decodePayload(const juce::uint8* data, size_t size,
+                                        double timeScale, double coordScale,
+                                        std::map<int, EventLane>& lanes)
+{
+    VarintReader reader { data, size };
+
+    const juce::uint64 numLanes = reader.read();
+
+    // 每個 lane 至少 3 bytes 的標頭，用剩餘大小驗證而不是固定上限
+    if (reader.failed || numLanes > reader.remaining() / 3)
+        return false;
+
+    for (juce::uint64 l = 0; l < numLanes; ++l)
+    {
+        const juce::int64 ballId = zigzagDecode(reader.read());
+        const juce::uint64 numEvents = reader.read();
+        const juce::uint64 laneFlags = reader.read();
+
+        if (reader.failed
+            || ballId < std::numeric_limits<int>::min() || ballId > std::numeric_limits<int>::max())
+            return false;
+
+        // 每個事件至少佔 3 bytes（time, x, y 各一個 varint）
+        if (numEvents > reader.remaining() / 3)
+            return false;
+
+        const size_t n = static_cast<size_t>(numEvents);
+        std::vector<double> times;
+        std::vector<float> xs, ys, zs;
+
+        if (!readDeltaColumn(reader, times, n, timeScale)
+            || !readDeltaColumn(reader, xs, n, coordScale)
+            || !readDeltaColumn(reader, ys, n, coordScale))
+            return false;
+
+        if (laneFlags & laneHasZ)
+        {
+            if (!readDeltaColumn(reader, zs, n, coordScale))
+                return false;
+        }
+        else
+        {
+            zs.assign(n, 0.0f);
+        }
+
+        auto [it, inserted] = lanes.try_emplace(static_cast<int>(ballId));
+        if (!inserted)
+            return false;  // 同一個球出現兩次
+
+        auto& lane = it->second;
+        lane.assignColumns(std::move(times), std::move(xs), std::move(ys), std::move(zs));
+        lane.sortByTime();  // 正常情況下已排序（只做一次檢查）
+        lane.markModified();
+    }
+
+    return true;
+}
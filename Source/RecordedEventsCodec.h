@@ -0,0 +1,71 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <map>
+#include "EventLane.h"
+
+//==============================================================================
+/**
+ * 錄製數據的壓縮二進位格式（"RECZ"）
+ *
+ * 舊的 "RECM" 格式每個事件固定 24 bytes（並重複保存 ballId）。新格式：
+ *  - 時間與座標先量化成整數，再對前一個事件做差分，以 zigzag varint 保存
+ *  - 按欄位（time / x / y / z）分段寫入，差分值相近，壓縮效果更好
+ *  - z 全部為 0 的 lane 不保存 z 欄位
+ *  - 資料量大時再以 GZIP（zlib）壓縮
+ *
+ * 區塊佈局（marker 由呼叫者寫入/讀取）：
+ *   int version, int flags, double timeScale, double coordScale, int payloadSize, payload[payloadSize]
+ * 壓縮時（版本 2 起）payload 開頭是 int decodedSize，之後才是 GZIP 數據；
+ * 解壓縮最多讀取 decodedSize 個 bytes，實際大小不符時整個區塊無效
+ * 解壓縮後的 payload：
+ *   varint numLanes
+ *   每個 lane：zigzag ballId, varint numEvents, varint laneFlags, 然後各欄位的 zigzag 差分
+ */
+class RecordedEventsCodec
+{
+public:
+    static constexpr int marker = 0x5245435A;  // "RECZ"
+    static constexpr int currentVersion = 2;
+
+    // 量化精度：1 PPQ = 10^6 個時間單位；座標 1.0 = 65536 個單位（約 1.5e-5 的誤差）
+    static constexpr double defaultTimeScale = 1000000.0;
+    static constexpr double defaultCoordScale = 65536.0;
+
+    // payload 超過這個大小才壓縮（小資料壓縮反而變大）
+    static constexpr size_t compressionThreshold = 4096;
+
+    // 解壓縮後 payload 的上限（版本 1 沒有保存解壓縮後的大小，只能以此限制）
+    static constexpr size_t maxDecodedPayloadSize = 256 * 1024 * 1024;
+
+    enum class ReadResult
+    {
+        loaded,        // lanes 已被取代
+        skipped,       // 區塊無法使用（版本不支援、資料損毀），stream 停在區塊之後
+        streamCorrupt  // 區塊大小無法讀取，stream 停在區塊中間，之後的數據都不可信
+    };
+
+    // 寫入區塊（不含 marker）；NaN/Inf 的事件會被略過
+    static void write(juce::OutputStream& stream, const std::map<int, EventLane>& lanes);
+
+    // 讀取區塊（marker 已被讀取）到 lanes；只有返回 loaded 時 lanes 才會被修改
+    static ReadResult read(juce::InputStream& stream, std::map<int, EventLane>& lanes);
+
+private:
+    enum Flags
+    {
+        payloadIsCompressed = 1 << 0
+    };
+
+    enum LaneFlags
+    {
+        laneHasZ = 1 << 0
+    };
+
+    // 解壓縮 payload；decodedSize < 0 代表大小未知（版本 1），超過上限或大小不符時返回 false
+    static bool decompressPayload(const void* data, size_t size, juce::int64 decodedSize, juce::MemoryBlock& decoded);
+
+    static bool decodePayload(const juce::uint8* data, size_t size,
+                              double timeScale, double coordScale,
+                              std::map<int, EventLane>& lanes);
+};
@@ -0,0 +1,98 @@
+#include "RecordingCapture.h"
+#include "JYPad.h"
+#include <algorithm>
+
+//==============================================================================
+RecordingCapture::RecordingCapture(JYPad& pad)
+    : juce::Thread("JYPad Recording Merger"),
+      jyPad(pad)
+{
+    // 預先配置合併用的暫存區，合併時不需要再配置記憶體
+    staging.reserve(static_cast<size_t>(queueCapacity) * queues.size());
+    startThread();
+}
+
+RecordingCapture::~RecordingCapture()
+{
+    stopThread(1000);
+}
+
+//==============================================================================
+bool RecordingCapture::push(CaptureProducer producer, const CapturedEvent& event) noexcept
+{
+    auto& queue = queues[static_cast<size_t>(producer)];
+
+    int start1, size1, start2, size2;
+    queue.fifo.prepareToWrite(1, start1, size1, start2, size2);
+
+    if (size1 + size2 < 1)
+    {
+        ++numDroppedEvents;
+        return false;
+    }
+
+    queue.buffer[static_cast<size_t>(size1 > 0 ? start1 : start2)] = event;
+    queue.fifo.finishedWrite(1);
+    return true;
+}
+
+void RecordingCapture::flush()
+{
+    drainAndMerge();
+}
+
+int RecordingCapture::getNumPendingEvents() const noexcept
+{
+    int total = 0;
+    for (const auto& queue : queues)
+        total += queue.fifo.getNumReady();
+    return total;
+}
+
+//==============================================================================
+void RecordingCapture::run()
+{
+    while (!threadShouldExit())
+    {
+        drainAndMerge();
+        wait(mergeIntervalMs);
+    }
+}
+
+void RecordingCapture::drainAndMerge()
+{
+    const juce::ScopedLock lock(mergeLock);
+
+    staging.clear();
+
+    for (auto& queue : queues)
+    {
+        const int numReady = queue.fifo.getNumReady();
+        if (numReady <= 0)
+            continue;
+
+        int start1, size1, start2, size2;
+        queue.fifo.prepareToRead(numReady, start1, size1, start2, size2);
+
+        for (int i = 0; i < size1; ++i)
+            staging.push_back(queue.buffer[static_cast<size_t>(start1 + i)]);
+        for (int i = 0; i < size2; ++i)
+            staging.push_back(queue.buffer[static_cast<size_t>(start2 + i)]);
+
+        queue.fifo.finishedRead(size1 + size2);
+    }
+
+    if (staging.empty())
+        return;
+
+    // 依球分組、組內依時間排序（穩定排序：同時間的事件保持到達順序）
+    std::stable_sort(staging.begin(), staging.end(),
+        [](const CapturedEvent& a, const CapturedEvent& b)
+        {
+            if (a.ballId != b.ballId)
+                return a.ballId < b.ballId;
+            return a.midiTime < b.midiTime;
+        });
+
+    jyPad.mergeCapturedEvents(staging.data(), staging.size());
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <array>
+#include <vector>
+
+class JYPad;
+
+//==============================================================================
+/**
+ * 擷取到的錄製事件（尚未合併進 JYPad 的 EventLane）
+ */
+struct CapturedEvent
+{
+    int ballId = 0;
+    double midiTime = 0.0;  // PPQ position (MIDI time)
+    float x = 0.0f;
+    float y = 0.0f;
+    float z = 0.0f;
+};
+
+// 錄製事件的來源：每個來源有自己的單生產者佇列，所以彼此之間不需要鎖
+enum class CaptureProducer
+{
+    mouse = 0,   // JYPadEditor::mouseDrag()
+    oscInput,    // 外部 OSC 輸入
+    script,      // 腳本或其他程式化輸入
+    numProducers
+};
+
+//==============================================================================
+/**
+ * 錄製擷取佇列與背景合併線程
+ *
+ * 生產者（拖動、OSC、腳本）只把事件推進自己的 wait-free 單生產者佇列
+ * （juce::AbstractFifo），不會排序也不會配置記憶體；
+ * 背景線程定期把所有佇列取出、依球與時間排序後合併進 JYPad 的錄製數據。
+ */
+class RecordingCapture : private juce::Thread
+{
+public:
+    explicit RecordingCapture(JYPad& pad);
+    ~RecordingCapture() override;
+
+    // 推入一個事件（wait-free）。每個 producer 同時只能有一個線程呼叫。
+    // 佇列滿時返回 false，事件會被丟棄並計入 getNumDroppedEvents()
+    bool push(CaptureProducer producer, const CapturedEvent& event) noexcept;
+
+    // 立即把所有佇列中的事件合併進 JYPad（例如存檔前）
+    // 呼叫時不能持有 JYPad 的 state lock
+    void flush();
+
+    int getNumPendingEvents() const noexcept;
+    juce::int64 getNumDroppedEvents() const noexcept { return numDroppedEvents.load(); }
+
+    // 每個生產者佇列的容量
+    static constexpr int queueCapacity = 16384;
+
+private:
+    struct ProducerQueue
+    {
+        ProducerQueue() : fifo(queueCapacity), buffer(static_cast<size_t>(queueCapacity)) {}
+
+        juce::AbstractFifo fifo;
+        std::vector<CapturedEvent> buffer;
+    };
+
+    JYPad& jyPad;
+    std::array<ProducerQueue, static_cast<size_t>(CaptureProducer::numProducers)> queues;
+    std::atomic<juce::int64> numDroppedEvents { 0 };
+
+    // 只保護消費者端（合併線程與 flush() 呼叫者），生產者永遠不碰這個鎖
+    juce::CriticalSection mergeLock;
+    std::vector<CapturedEvent> staging;
+
+    // 合併線程的輪詢間隔
+    static constexpr int mergeIntervalMs = 10;
+
+    void run() override;
+    void drainAndMerge();
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(RecordingCapture)
+};
@@ -0,0 +1,125 @@
+#include "TrajectoryInterpolator.h"
+
+//==============================================================================
+namespace
+{
+    // 三次 Hermite 基底：p0、p1 為端點，m0、m1 為對時間的斜率，h 為時間間隔，s 為 0..1
+    float hermiteBasis(float p0, float p1, double m0, double m1, double h, double s) noexcept
+    {
+        const double s2 = s * s;
+        const double s3 = s2 * s;
+        const double h00 = 2.0 * s3 - 3.0 * s2 + 1.0;
+        const double h10 = s3 - 2.0 * s2 + s;
+        const double h01 = -2.0 * s3 + 3.0 * s2;
+        const double h11 = s3 - s2;
+        return static_cast<float>(h00 * p0 + h10 * h * m0 + h01 * p1 + h11 * h * m1);
+    }
+
+    // Catmull-Rom：切線為前後事件的差分（依時間），端點使用區段本身的斜率
+    float catmullRom(ColumnSpan<double> t, ColumnSpan<float> p, size_t i, double s) noexcept
+    {
+        const size_t n = t.size;
+        const double h = t[i + 1] - t[i];
+        const double secant = (p[i + 1] - p[i]) / h;
+
+        double m0 = secant;
+        if (i > 0 && t[i + 1] > t[i - 1])
+            m0 = (p[i + 1] - p[i - 1]) / (t[i + 1] - t[i - 1]);
+
+        double m1 = secant;
+        if (i + 2 < n && t[i + 2] > t[i])
+            m1 = (p[i + 2] - p[i]) / (t[i + 2] - t[i]);
+
+        return hermiteBasis(p[i], p[i + 1], m0, m1, h, s);
+    }
+
+    // Fritsch–Carlson 單調切線：相鄰斜率異號（或為 0）時切線為 0，否則取加權調和平均
+    double monotoneTangent(ColumnSpan<double> t, ColumnSpan<float> p, size_t k) noexcept
+    {
+        const size_t n = t.size;
+        const bool hasPrevious = k > 0 && t[k] > t[k - 1];
+        const bool hasNext = k + 1 < n && t[k + 1] > t[k];
+
+        if (!hasPrevious && !hasNext)
+            return 0.0;
+
+        const double hNext = hasNext ? t[k + 1] - t[k] : 0.0;
+        const double hPrevious = hasPrevious ? t[k] - t[k - 1] : 0.0;
+        const double dNext = hasNext ? (p[k + 1] - p[k]) / hNext : 0.0;
+        const double dPrevious = hasPrevious ? (p[k] - p[k - 1]) / hPrevious : 0.0;
+
+        if (!hasPrevious)
+            return dNext;
+        if (!hasNext)
+            return dPrevious;
+
+        if (dPrevious * dNext <= 0.0)
+            return 0.0;
+
+        const double w1 = 2.0 * hNext + hPrevious;
+        const double w2 = hNext + 2.0 * hPrevious;
+        return (w1 + w2) / (w1 / dPrevious + w2 / dNext);
+    }
+
+    float monotoneHermite(ColumnSpan<double> t, ColumnSpan<float> p, size_t i, double s) noexcept
+    {
+        const double h = t[i + 1] - t[i];
+        return hermiteBasis(p[i], p[i + 1], monotoneTangent(t, p, i), monotoneTangent(t, p, i + 1), h, s);
+    }
+}
+
+//==============================================================================
+juce::String TrajectoryInterpolator::getModeName(Mode mode)
+{
+    switch (mode)
+    {
+        case Mode::step:        return "Step";
+        case Mode::linear:      return "Linear";
+        case Mode::catmullRom:  return "Catmull-Rom";
+        case Mode::hermite:     return "Hermite (monotone)";
+        case Mode::numModes:    break;
+    }
+    return {};
+}
+
+RecordedEvent TrajectoryInterpolator::evaluate(const EventLane& lane, int index, double midiTime, Mode mode) noexcept
+{
+    jassert(index >= 0 && static_cast<size_t>(index) < lane.size());
+
+    const auto i = static_cast<size_t>(index);
+
+    // 最後一個事件之後（或 step 模式）停在該事件
+    // findLastAtOrBefore 保證 t[i] <= midiTime < t[i + 1]，所以區段長度一定大於 0
+    if (mode == Mode::step || i + 1 >= lane.size())
+        return lane.getEvent(i);
+
+    const auto t = lane.getTimes();
+    const auto xs = lane.getXs();
+    const auto ys = lane.getYs();
+    const auto zs = lane.getZs();
+    const double s = juce::jlimit(0.0, 1.0, (midiTime - t[i]) / (t[i + 1] - t[i]));
+
+    switch (mode)
+    {
+        case Mode::linear:
+        {
+            const auto lerp = [i, s](ColumnSpan<float> p)
+            {
+                return static_cast<float>(p[i] + (p[i + 1] - p[i]) * s);
+            };
+            return { midiTime, lerp(xs), lerp(ys), lerp(zs) };
+        }
+
+        case Mode::catmullRom:
+            return { midiTime, catmullRom(t, xs, i, s), catmullRom(t, ys, i, s), catmullRom(t, zs, i, s) };
+
+        case Mode::hermite:
+            return { midiTime, monotoneHermite(t, xs, i, s), monotoneHermite(t, ys, i, s), monotoneHermite(t, zs, i, s) };
+
+        case Mode::step:
+        case Mode::numModes:
+            break;
+    }
+
+    return lane.getEvent(i);
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include "EventLane.h"
+
+//==============================================================================
+/**
+ * 錄製軌跡的插值
+ * 在兩個錄製事件之間依時間估計球的位置，讓稀疏的 lane 也能平滑回放。
+ *
+ *  - step：停在 <= t 的最後一個事件（舊行為）
+ *  - linear：兩點之間線性插值
+ *  - catmullRom：以前後事件的差分作為切線的三次曲線（依實際時間間隔，非均勻）
+ *  - hermite：單調三次 Hermite（Fritsch–Carlson），不會超出相鄰事件之間的範圍
+ */
+class TrajectoryInterpolator
+{
+public:
+    enum class Mode
+    {
+        step = 0,
+        linear,
+        catmullRom,
+        hermite,
+        numModes
+    };
+
+    static juce::String getModeName(Mode mode);
+
+    // index 必須是 lane.findLastAtOrBefore(midiTime) 的結果（>= 0）
+    // 之後沒有事件時停在最後一個事件
+    static RecordedEvent evaluate(const EventLane& lane, int index, double midiTime, Mode mode) noexcept;
+};
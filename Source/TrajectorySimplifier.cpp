@@ -0,0 +1,135 @@
+#include "TrajectorySimplifier.h"
+#include "JYPad.h"
+#include "DebugLogger.h"
+#include <juce_events/juce_events.h>
+
+//==============================================================================
+std::vector<size_t> TrajectorySimplifier::findEventsToKeep(const EventLane& lane, float tolerance)
+{
+    const size_t numEvents = lane.size();
+    std::vector<size_t> kept;
+
+    if (numEvents <= 2)
+    {
+        for (size_t i = 0; i < numEvents; ++i)
+            kept.push_back(i);
+        return kept;
+    }
+
+    const auto times = lane.getTimes();
+    const auto xs = lane.getXs();
+    const auto ys = lane.getYs();
+    const auto zs = lane.getZs();
+    const double toleranceSquared = static_cast<double>(tolerance) * static_cast<double>(tolerance);
+
+    auto distanceSquared = [&](size_t a, size_t b)
+    {
+        const double dx = static_cast<double>(xs[a]) - xs[b];
+        const double dy = static_cast<double>(ys[a]) - ys[b];
+        const double dz = static_cast<double>(zs[a]) - zs[b];
+        return dx * dx + dy * dy + dz * dz;
+    };
+
+    // linear 回放：first 與 last 之間的每個事件與同一時間的插值位置比較
+    auto fitsLinearSegment = [&](size_t first, size_t last)
+    {
+        const double duration = times[last] - times[first];
+
+        for (size_t i = first + 1; i < last; ++i)
+        {
+            const double u = duration > 0.0 ? (times[i] - times[first]) / duration : 0.0;
+            const double dx = xs[i] - (xs[first] + (static_cast<double>(xs[last]) - xs[first]) * u);
+            const double dy = ys[i] - (ys[first] + (static_cast<double>(ys[last]) - ys[first]) * u);
+            const double dz = zs[i] - (zs[first] + (static_cast<double>(zs[last]) - zs[first]) * u);
+
+            if (dx * dx + dy * dy + dz * dz > toleranceSquared)
+                return false;
+        }
+
+        return true;
+    };
+
+    kept.push_back(0);
+    size_t anchor = 0;
+
+    while (anchor < numEvents - 1)
+    {
+        const size_t limit = std::min(numEvents - 1, anchor + maxSegmentLength);
+        size_t next = anchor + 1;
+
+        for (size_t candidate = anchor + 2; candidate <= limit; ++candidate)
+        {
+            // candidate - 1 會被刪除：step 回放時在它的時間顯示的是 anchor 的位置
+            // 之後的候選點也都要刪除它，所以超過容許值時不用再往後找
+            if (distanceSquared(candidate - 1, anchor) > toleranceSquared)
+                break;
+
+            // linear 的誤差不隨距離單調增加：這個候選點不行時繼續嘗試更遠的
+            if (fitsLinearSegment(anchor, candidate))
+                next = candidate;
+        }
+
+        kept.push_back(next);
+        anchor = next;
+    }
+
+    return kept;
+}
+
+//==============================================================================
+TrajectorySimplifier::Job::Job(JYPad& pad, std::vector<int> ids, float tol,
+                               std::function<void(const Result&)> callback)
+    : juce::ThreadPoolJob("JYPad Simplify Recordings"),
+      jyPad(pad),
+      ballIds(std::move(ids)),
+      tolerance(tol),
+      onComplete(std::move(callback))
+{
+}
+
+juce::ThreadPoolJob::JobStatus TrajectorySimplifier::Job::runJob()
+{
+    Result result;
+
+    // 先把擷取佇列中還沒合併的事件合併進來
+    jyPad.flushPendingRecordings();
+
+    if (ballIds.empty())
+        ballIds = jyPad.getBallIdsWithEvents();
+
+    for (int ballId : ballIds)
+    {
+        if (shouldExit())
+            return jobHasFinished;
+
+        // 分段複製一份快照，之後的計算不持有鎖（不會擋住 UI 或音訊線程）
+        juce::uint32 revision = 0;
+        auto snapshot = jyPad.copyLane(ballId, revision);
+        if (!snapshot.has_value() || snapshot->empty())
+            continue;
+
+        const auto kept = findEventsToKeep(*snapshot, tolerance);
+
+        if (jyPad.retainLaneEvents(ballId, revision, kept))
+        {
+            ++result.lanesSimplified;
+            result.eventsBefore += snapshot->size();
+            result.eventsAfter += kept.size();
+        }
+        else
+        {
+            ++result.lanesSkipped;
+        }
+    }
+
+    DEBUG_LOG("TrajectorySimplifier: " + juce::String(static_cast<juce::int64>(result.eventsBefore)) + " -> "
+              + juce::String(static_cast<juce::int64>(result.eventsAfter)) + " events");
+
+    if (onComplete)
+    {
+        auto callback = onComplete;
+        juce::MessageManager::callAsync([callback, result]() { callback(result); });
+    }
+
+    return jobHasFinished;
+}
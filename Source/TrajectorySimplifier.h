@@ -0,0 +1,58 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <functional>
+#include <vector>
+#include "EventLane.h"
+
+class JYPad;
+
+//==============================================================================
+/**
+ * 軌跡簡化（離線）
+ * 刪除回放時可以在容許值內重現的錄製事件（邏輯座標單位）。
+ * 每個被刪除的事件必須同時符合兩種回放方式：
+ *   - step（保持上一個值，預設）：與它之前最後一個保留事件的距離不超過容許值
+ *   - linear：與前後保留事件在同一時間的線性插值位置（同步歐氏距離）不超過容許值
+ * 所以不論回放使用哪一種模式、之後是否切換，簡化都不會明顯改變動作。
+ * 從每個保留點貪婪地向後延伸到最遠、仍然符合兩個條件的事件。
+ */
+class TrajectorySimplifier
+{
+public:
+    struct Result
+    {
+        int lanesSimplified = 0;
+        int lanesSkipped = 0;       // 簡化期間 lane 被修改過，沒有套用
+        size_t eventsBefore = 0;
+        size_t eventsAfter = 0;
+    };
+
+    // 返回要保留的事件索引（遞增排序，首尾一定保留）
+    static std::vector<size_t> findEventsToKeep(const EventLane& lane, float tolerance);
+
+    // 兩個保留事件之間最多的事件數（限制靜止不動的長段落的計算量）
+    static constexpr size_t maxSegmentLength = 256;
+
+    //==============================================================================
+    /**
+     * 背景簡化工作（交給 juce::ThreadPool 執行）
+     * ballIds 為空時處理所有有錄製數據的球；完成後在訊息線程呼叫 onComplete
+     */
+    class Job : public juce::ThreadPoolJob
+    {
+    public:
+        Job(JYPad& pad, std::vector<int> ballIds, float tolerance,
+            std::function<void(const Result&)> onComplete);
+
+        JobStatus runJob() override;
+
+    private:
+        JYPad& jyPad;
+        std::vector<int> ballIds;
+        float tolerance;
+        std::function<void(const Result&)> onComplete;
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Job)
+    };
+};